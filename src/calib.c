@@ -0,0 +1,138 @@
+/**
+ * @file calib.c
+ * @brief Реализация калибровки смещения нуля акселерометра
+ */
+
+#include "calib.h"
+#include "adxl345.h"
+#include "eeprom.h"
+#include "tim4.h"
+
+/* Запись в EEPROM: признак, три поправки, CRC8 по предыдущим байтам */
+#define CALIB_RECORD_SIZE 5
+
+/* Ожидание одной выборки: два периода выдачи данных с запасом, мс */
+#define CALIB_READY_TIMEOUT_MS(period_us) ((period_us) / 500UL + 2)
+
+/* CRC-8, полином x^8 + x^2 + x + 1 (0x07), начальное значение 0 */
+static uint8_t calib_crc8(const uint8_t *data, uint8_t length)
+{
+    uint8_t crc = 0;
+    uint8_t bit;
+
+    while (length--)
+    {
+        crc ^= *data++;
+        for (bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/* Поправка в единицах регистра смещения с округлением к ближайшему */
+static int8_t calib_offset(int32_t sum, int16_t expected)
+{
+    int32_t error = (sum >> CALIB_SAMPLES_LOG2) - expected;
+
+    error = (error >= 0) ? (error + CALIB_COUNTS_PER_OFFSET / 2) / CALIB_COUNTS_PER_OFFSET
+                         : (error - CALIB_COUNTS_PER_OFFSET / 2) / CALIB_COUNTS_PER_OFFSET;
+    if (error > 127)
+    {
+        error = 127;
+    }
+    if (error < -127)
+    {
+        error = -127;
+    }
+    return (int8_t)-error;
+}
+
+void calib_apply(const calib_t *calib)
+{
+    ADXL345_WriteReg(ADXL345_REG_OFSX, (uint8_t)calib->offset[0]);
+    ADXL345_WriteReg(ADXL345_REG_OFSY, (uint8_t)calib->offset[1]);
+    ADXL345_WriteReg(ADXL345_REG_OFSZ, (uint8_t)calib->offset[2]);
+}
+
+uint8_t calib_run(calib_t *calib)
+{
+    int32_t sum[3];
+    int16_t x, y, z;
+    uint32_t timeout = CALIB_READY_TIMEOUT_MS(ADXL345_GetSamplePeriod());
+    uint32_t start;
+    uint16_t n;
+
+    /* Измерение без старых поправок */
+    calib->offset[0] = 0;
+    calib->offset[1] = 0;
+    calib->offset[2] = 0;
+    calib_apply(calib);
+
+    /* Выборка, накопленная со старыми поправками, отбрасывается */
+    ADXL345_ReadAccel(&x, &y, &z);
+
+    sum[0] = 0;
+    sum[1] = 0;
+    sum[2] = 0;
+    for (n = 0; n < (1 << CALIB_SAMPLES_LOG2); n++)
+    {
+        start = TIM4_GetMillis();
+        while (!(ADXL345_ReadReg(ADXL345_REG_INT_SOURCE) & ADXL345_INT_DATA_READY))
+        {
+            if (TIM4_ElapsedMillis(start) > timeout)
+            {
+                return 1;
+            }
+        }
+
+        ADXL345_ReadAccel(&x, &y, &z);
+        sum[0] += x;
+        sum[1] += y;
+        sum[2] += z;
+    }
+
+    calib->offset[0] = calib_offset(sum[0], 0);
+    calib->offset[1] = calib_offset(sum[1], 0);
+    calib->offset[2] = calib_offset(sum[2], CALIB_COUNTS_PER_G);
+    calib_apply(calib);
+
+    return 0;
+}
+
+uint8_t calib_save(const calib_t *calib)
+{
+    uint8_t record[CALIB_RECORD_SIZE];
+
+    record[0] = CALIB_MAGIC;
+    record[1] = (uint8_t)calib->offset[0];
+    record[2] = (uint8_t)calib->offset[1];
+    record[3] = (uint8_t)calib->offset[2];
+    record[4] = calib_crc8(record, CALIB_RECORD_SIZE - 1);
+
+    return EEPROM_Write(EEPROM_ADDR_CALIB, record, sizeof(record));
+}
+
+uint8_t calib_restore(calib_t *calib)
+{
+    uint8_t record[CALIB_RECORD_SIZE];
+
+    if (EEPROM_Read(EEPROM_ADDR_CALIB, record, sizeof(record)) != 0)
+    {
+        return 1;
+    }
+
+    /* Чистая EEPROM (0xFF) и поврежденная запись отбрасываются */
+    if (record[0] != CALIB_MAGIC || record[4] != calib_crc8(record, CALIB_RECORD_SIZE - 1))
+    {
+        return 1;
+    }
+
+    calib->offset[0] = (int8_t)record[1];
+    calib->offset[1] = (int8_t)record[2];
+    calib->offset[2] = (int8_t)record[3];
+    calib_apply(calib);
+
+    return 0;
+}
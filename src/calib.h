@@ -0,0 +1,74 @@
+/**
+ * @file calib.h
+ * @brief Калибровка смещения нуля акселерометра ADXL345
+ *
+ * Калибровка усредняет выборки в известном положении (плата лежит горизонтально, ось Z вверх)
+ * и записывает поправки в аппаратные регистры OFSX/OFSY/OFSZ. Результат сохраняется в EEPROM
+ * с CRC8 по адресу @ref EEPROM_ADDR_CALIB, и при следующем запуске восстанавливается одним
+ * чтением вместо повторной калибровки.
+ */
+
+#ifndef CALIB_H
+#define CALIB_H
+
+#include <stdint.h>
+
+/** @brief log2 количества усредняемых выборок (64 выборки — 0,64 с при 100 Гц) */
+#ifndef CALIB_SAMPLES_LOG2
+#define CALIB_SAMPLES_LOG2 6
+#endif
+
+/** @brief Отсчетов на 1g в режиме Full Resolution (3,9 мг/LSB) */
+#define CALIB_COUNTS_PER_G 256
+
+/** @brief Отсчетов Full Resolution на единицу регистра смещения (15,6 мг/LSB) */
+#define CALIB_COUNTS_PER_OFFSET 4
+
+/** @brief Признак записи калибровки в EEPROM */
+#define CALIB_MAGIC 0xCA
+
+/**
+ * @struct calib_t
+ * @brief Калибровочные поправки
+ */
+typedef struct
+{
+    int8_t offset[3]; /**< Значения регистров OFSX, OFSY, OFSZ */
+} calib_t;
+
+/**
+ * @brief Калибровка в горизонтальном положении
+ *
+ * Сбрасывает регистры смещения, усредняет 2^@ref CALIB_SAMPLES_LOG2 выборок по готовности
+ * данных и записывает поправки так, чтобы X = Y = 0, Z = +1g. Частота выдачи данных должна
+ * быть установлена заранее, прерывания INT1 акселерометра — выключены.
+ *
+ * @param[out] calib Вычисленные поправки
+ * @retval 0 Успешно
+ * @retval 1 Данные не поступают от датчика
+ */
+uint8_t calib_run(calib_t *calib);
+
+/**
+ * @brief Запись поправок в регистры OFSX/OFSY/OFSZ
+ */
+void calib_apply(const calib_t *calib);
+
+/**
+ * @brief Сохранение поправок в EEPROM
+ *
+ * @retval 0 Успешно
+ * @retval 1 Ошибка записи
+ */
+uint8_t calib_save(const calib_t *calib);
+
+/**
+ * @brief Чтение поправок из EEPROM и запись в регистры датчика
+ *
+ * @param[out] calib Прочитанные поправки
+ * @retval 0 Поправки восстановлены
+ * @retval 1 Запись отсутствует, повреждена или не читается
+ */
+uint8_t calib_restore(calib_t *calib);
+
+#endif /* CALIB_H */
@@ -3,13 +3,14 @@
  */
 
 #include "delay.h"
+#include "clk.h"
 
 void delay(uint32_t ms)
 {
     while (ms--)
     {
         volatile uint16_t i;
-        for (i = 0; i < 127; ++i) // Откалибровано c помощью осциллографа для STM8S103 16 MHz, погрешность менее 5%
+        for (i = 0; i < CLK_DELAY_LOOPS_PER_MS; ++i) // ~16 тактов на итерацию, откалибровано c помощью осциллографа, погрешность менее 5%
         {
             _asm("nop"); // Ассемблерная команда "ничего не делать"
         }
@@ -5,38 +5,272 @@
 
 #include "adxl345.h"
 #include "spi.h"
+#include "clk.h"
+#include "tim4.h"
 #include "my_iostm8s103.h"
 
+/* Профиль ADXL345 на шине SPI: режим 3 (CPOL = 1, CPHA = 1), SCK не выше 5 МГц, CS на PA3 */
+static const SPI_Device_t adxl345_spi = {
+    SPI_BAUDRATE_FOR(ADXL345_SPI_MAX_HZ) | SPI_CR1_CPOL | SPI_CR1_CPHA,
+    SPI_CS_PORT(PA_ODR),
+    (1 << 3)};
+
 /* Макросы для управления линией CS (Chip Select) */
-#define ADXL345_CS_LOW() (PA_ODR &= ~(1 << 3)) /**< Установить линию CS в низкий уровень */
-#define ADXL345_CS_HIGH() (PA_ODR |= (1 << 3)) /**< Установить линию CS в высокий уровень */
+#define ADXL345_CS_LOW() SPI_Select(&adxl345_spi)    /**< Выбрать устройство (CS в низкий уровень) */
+#define ADXL345_CS_HIGH() SPI_Deselect(&adxl345_spi) /**< Освободить устройство (CS в высокий уровень) */
+
+/* Выводы INT1 и INT2 акселерометра: PD3 и PD2, EXTI порта D */
+#define ADXL345_INT1_PIN (1 << 3)
+#define ADXL345_INT2_PIN (1 << 2)
+
+/* EXTI_CR1.PDIS[7:6]: чувствительность порта D, 01 — только передний фронт */
+#define ADXL345_EXTI_PD_MASK 0xC0
+#define ADXL345_EXTI_PD_RISING 0x40
+
+/* Пауза после чтения выборки из FIFO: не менее 5 мкс до следующего обращения (~5 тактов на итерацию) */
+#define ADXL345_FIFO_POP_LOOPS ((uint8_t)(F_CPU / 1000000UL))
+
+/* Максимальное число проходов выгрузки за один вызов ADXL345_ReadSample (по порогу FIFO на проход) */
+#define ADXL345_DRAIN_ROUNDS 4
+
+/*
+ * Пока включено прерывание INT1 или INT2, обработчик сам обращается к SPI. Обмен из основного цикла
+ * выполняется при запрещенных прерываниях, чтобы обработчик не вклинился в чужую транзакцию.
+ */
+#define ADXL345_LOCK(cc)                  \
+    do                                    \
+    {                                     \
+        if (adxl345_irq_on)               \
+            (cc) = IRQ_SAVE_DISABLE();    \
+    } while (0)
+#define ADXL345_UNLOCK(cc)                \
+    do                                    \
+    {                                     \
+        if (adxl345_irq_on)               \
+            IRQ_RESTORE(cc);              \
+    } while (0)
+
+/* Источник прерывания на INT1 */
+#define ADXL345_INT1_NONE 0
+#define ADXL345_INT1_FIFO 1
+#define ADXL345_INT1_DATA_READY 2
+
+/* Период выдачи данных после ADXL345_Init (100 Гц), мкс */
+#define ADXL345_DEFAULT_PERIOD_US 10000UL
+
+/* Период выдачи данных в режиме сна (POWER_CTL.WAKEUP = 00: 8 Гц), мкс */
+#define ADXL345_SLEEP_PERIOD_US 125000UL
+
+/* Период при коде частоты 0: 10,24 с; каждый следующий код делит его пополам (3200 Гц — 312 мкс) */
+#define ADXL345_RATE0_PERIOD_US 10240000UL
+
+static uint8_t adxl345_irq_on;   /* Маска выводов (ADXL345_INTx_PIN) с включенным прерыванием */
+static uint8_t adxl345_int1_mode; /* ADXL345_INT1_* */
+static uint8_t adxl345_watermark; /* Порог FIFO, при котором INT1 в высоком уровне */
+static volatile uint8_t adxl345_drain_pending; /* Обработчик оставил в FIFO не менее порога выборок */
+static uint32_t adxl345_period_us = ADXL345_DEFAULT_PERIOD_US; /* Период выдачи данных */
+static uint32_t adxl345_rate_period_us = ADXL345_DEFAULT_PERIOD_US; /* Период по BW_RATE (вне сна) */
+static uint8_t adxl345_auto_sleep;          /* В покое датчик засыпает и выдает данные с частотой 8 Гц */
+static volatile uint8_t adxl345_active = 1; /* Состояние по последнему событию активности/неактивности */
+static uint8_t adxl345_events_on;           /* Детекторы удара и падения включены */
+
+/* Очередь событий: заполняется обработчиком прерывания, читается основным циклом */
+static ADXL345_Event_t adxl345_events[ADXL345_EVENT_QUEUE_SIZE];
+static volatile uint8_t adxl345_event_head;
+static volatile uint8_t adxl345_event_tail;
+
+/* Кольцевой буфер выборок: заполняется обработчиком прерывания, читается основным циклом */
+static ADXL345_Sample_t adxl345_ring[ADXL345_RING_SIZE];
+static volatile uint8_t adxl345_ring_head;
+static volatile uint8_t adxl345_ring_tail;
+static volatile uint16_t adxl345_dropped;
+static ADXL345_Sample_t adxl345_scratch; /* Приемник выборки при полном буфере */
+
+static uint8_t ADXL345_ReadRegRaw(uint8_t regAddr)
+{
+    uint8_t frame[2];
+
+    frame[0] = 0x80 | (regAddr & 0x3F); /* Адрес регистра с битом RW = 1 (чтение) */
+    frame[1] = SPI_DUMMY_BYTE;          /* Фиктивный байт, на котором приходят данные */
+
+    ADXL345_CS_LOW(); /* Активируем устройство */
+    SPI_Transfer(frame, frame, sizeof(frame));
+    ADXL345_CS_HIGH(); /* Деактивируем устройство */
+
+    return frame[1];
+}
+
+static void ADXL345_ReadBurst(uint8_t startRegAddr, uint8_t *buffer, uint8_t length)
+{
+    uint8_t command;
+
+    /* Адрес регистра с установленными битами чтения и многобайтной передачи (RW = 1, MB = 1) */
+    command = 0xC0 | (startRegAddr & 0x3F);
+
+    ADXL345_CS_LOW(); /* Активируем устройство */
+    SPI_Write(&command, 1);
+    SPI_Read(buffer, length); /* Данные идут пакетом без пауз между байтами */
+    ADXL345_CS_HIGH(); /* Деактивируем устройство */
+}
+
+/* Слот для записи новой выборки; при полном буфере выборку все равно нужно вычитать из датчика */
+static ADXL345_Sample_t *ADXL345_RingReserve(void)
+{
+    if ((uint8_t)(adxl345_ring_head - adxl345_ring_tail) >= ADXL345_RING_SIZE)
+    {
+        adxl345_dropped++;
+        return &adxl345_scratch;
+    }
+    return &adxl345_ring[adxl345_ring_head & (ADXL345_RING_SIZE - 1)];
+}
+
+static void ADXL345_RingCommit(ADXL345_Sample_t *slot)
+{
+    if (slot != &adxl345_scratch)
+    {
+        adxl345_ring_head++;
+    }
+}
+
+/* Чтение выходных регистров DATAX0..DATAZ1 одним пакетом; в режиме FIFO чтение DATAZ1 выталкивает выборку */
+static void ADXL345_ReadSampleRaw(ADXL345_Sample_t *sample)
+{
+    uint8_t buffer[6];
+
+    ADXL345_ReadBurst(ADXL345_REG_DATAX0, buffer, sizeof(buffer));
+
+    sample->x = (int16_t)((buffer[1] << 8) | buffer[0]);
+    sample->y = (int16_t)((buffer[3] << 8) | buffer[2]);
+    sample->z = (int16_t)((buffer[5] << 8) | buffer[4]);
+}
+
+/*
+ * Выгрузка FIFO в кольцевой буфер: за проход не более limit самых старых выборок, не более rounds проходов.
+ * Возвращает 1, если порог все еще достигнут: INT1 остается в высоком уровне и фронта не будет.
+ */
+static uint8_t ADXL345_DrainFifo(uint8_t rounds, uint8_t limit)
+{
+    ADXL345_Sample_t *slot;
+    uint32_t timestamp;
+    uint8_t entries, count;
+    volatile uint8_t i;
+
+    entries = ADXL345_ReadRegRaw(ADXL345_REG_FIFO_STATUS) & ADXL345_FIFO_ENTRIES_MASK;
+    while (entries >= adxl345_watermark)
+    {
+        if (rounds-- == 0)
+        {
+            return 1;
+        }
+
+        /* Самая новая выборка готова к моменту чтения, каждая более старая — на период раньше */
+        timestamp = TIM4_GetMicros() - (uint32_t)(entries - 1) * adxl345_period_us;
+        count = entries < limit ? entries : limit;
+        while (count--)
+        {
+            slot = ADXL345_RingReserve();
+            ADXL345_ReadSampleRaw(slot);
+            slot->timestamp = timestamp;
+            ADXL345_RingCommit(slot);
+            timestamp += adxl345_period_us;
+
+            /* Не менее 5 мкс до следующего обращения, пока FIFO выталкивает выборку */
+            for (i = 0; i < ADXL345_FIFO_POP_LOOPS; i++)
+                ;
+        }
+
+        entries = ADXL345_ReadRegRaw(ADXL345_REG_FIFO_STATUS) & ADXL345_FIFO_ENTRIES_MASK;
+    }
+    return 0;
+}
+
+/* Продолжение выгрузки, начатой обработчиком прерывания; каждый проход — при запрещенных прерываниях */
+static void ADXL345_FinishDrain(void)
+{
+    uint8_t rounds = ADXL345_DRAIN_ROUNDS;
+    uint8_t cc;
+
+    while (adxl345_drain_pending && rounds--)
+    {
+        cc = IRQ_SAVE_DISABLE();
+        adxl345_drain_pending = ADXL345_DrainFifo(1, adxl345_watermark);
+        IRQ_RESTORE(cc);
+    }
+}
+
+/* Чтение одной выборки по DATA_READY: чтение данных снимает флаг и опускает INT1 */
+static void ADXL345_CaptureSample(void)
+{
+    ADXL345_Sample_t *slot;
+    uint32_t timestamp = TIM4_GetMicros();
+
+    slot = ADXL345_RingReserve();
+    ADXL345_ReadSampleRaw(slot);
+    slot->timestamp = timestamp;
+    ADXL345_RingCommit(slot);
+}
 
 uint8_t ADXL345_Init(void)
 {
+    uint8_t deviceId;
+
+    SPI_DeviceInit(&adxl345_spi);
+
     /* Проверка идентификатора устройства */
-    uint8_t deviceId = ADXL345_ReadReg(ADXL345_REG_DEVID);
+    deviceId = ADXL345_ReadReg(ADXL345_REG_DEVID);
     if (deviceId != ADXL345_DEVICE_ID)
     {
         return 1; /**< Ошибка инициализации: неправильный идентификатор устройства */
     }
 
-    /* Установка диапазона измерений и формата данных */
-    /* Устанавливаем полный дуплекс*/
-    /* Устанавливаем полный диапазон ("Full Resolution") */
-    /* Устанавливаем +/-4g */
-    ADXL345_WriteReg(ADXL345_REG_DATA_FORMAT, 0x49);
+    /* Установка диапазона измерений и формата данных: 4-проводный SPI, Full Resolution, +/-4g */
+    ADXL345_SetRange(ADXL345_RANGE_4G);
 
-    /* Установка частоты данных */
-    /* Устанавливаем частоту данных 100 Гц */
-    ADXL345_WriteReg(ADXL345_REG_BW_RATE, 0x0A);
+    /* Установка частоты данных 100 Гц */
+    ADXL345_SetDataRate(ADXL345_RATE_100);
 
     /* Включение измерений */
     /* Устанавливаем бит Measure в регистре POWER_CTL */
-    ADXL345_WriteReg(ADXL345_REG_POWER_CTL, 0x08);
+    ADXL345_WriteReg(ADXL345_REG_POWER_CTL, ADXL345_POWER_MEASURE);
 
     return 0; // Успешная инициализация
 }
 
+void ADXL345_SetDataRate(ADXL345_DataRate_t rate)
+{
+    uint32_t period = ADXL345_RATE0_PERIOD_US >> ((uint8_t)rate & 0x0F);
+    uint8_t cc;
+
+    ADXL345_WriteReg(ADXL345_REG_BW_RATE, (uint8_t)rate & 0x0F);
+
+    /* Период читается обработчиком прерывания при выгрузке FIFO */
+    cc = IRQ_SAVE_DISABLE();
+    adxl345_rate_period_us = period;
+    if (adxl345_active || !adxl345_auto_sleep)
+    {
+        adxl345_period_us = period;
+    }
+    IRQ_RESTORE(cc);
+}
+
+uint32_t ADXL345_GetSamplePeriod(void)
+{
+    uint32_t period;
+    uint8_t cc;
+
+    cc = IRQ_SAVE_DISABLE();
+    period = adxl345_period_us;
+    IRQ_RESTORE(cc);
+
+    return period;
+}
+
+void ADXL345_SetRange(ADXL345_Range_t range)
+{
+    /* Бит SPI = 0 (4-проводный), INT_INVERT = 0 (активный высокий), JUSTIFY = 0 (вправо) */
+    ADXL345_WriteReg(ADXL345_REG_DATA_FORMAT, ADXL345_FORMAT_FULL_RES | ((uint8_t)range & 0x03));
+}
+
 void ADXL345_ReadAccel(int16_t *x, int16_t *y, int16_t *z)
 {
     uint8_t buffer[6];
@@ -52,48 +286,391 @@ void ADXL345_ReadAccel(int16_t *x, int16_t *y, int16_t *z)
 
 void ADXL345_WriteReg(uint8_t regAddr, uint8_t data)
 {
-    ADXL345_CS_LOW(); /* Активируем устройство путем опускания CS */
+    uint8_t frame[2];
+    uint8_t cc = 0;
 
-    /* Отправляем адрес регистра с установленным битом записи (бит RW = 0) */
-    SPI_ReadWriteByte(regAddr & 0x3F); /* Обеспечиваем, что биты RW и MB установлены в 0 */
-
-    /* Отправляем данные */
-    SPI_ReadWriteByte(data);
+    frame[0] = regAddr & 0x3F; /* Адрес регистра, биты RW и MB сброшены (запись) */
+    frame[1] = data;           /* Данные */
 
+    ADXL345_LOCK(cc);
+    ADXL345_CS_LOW(); /* Активируем устройство путем опускания CS */
+    SPI_Write(frame, sizeof(frame));
     ADXL345_CS_HIGH(); /* Деактивируем устройство путем поднятия CS */
+    ADXL345_UNLOCK(cc);
 }
 
 uint8_t ADXL345_ReadReg(uint8_t regAddr)
 {
     uint8_t data;
+    uint8_t cc = 0;
 
-    ADXL345_CS_LOW(); /* Активируем устройство */
+    ADXL345_LOCK(cc);
+    data = ADXL345_ReadRegRaw(regAddr);
+    ADXL345_UNLOCK(cc);
+
+    return data;
+}
+
+void ADXL345_ReadMultBytes(uint8_t startRegAddr, uint8_t *buffer, uint8_t length)
+{
+    uint8_t cc = 0;
 
-    /* Отправляем адрес регистра с установленным битом чтения (бит RW = 1) */
-    SPI_ReadWriteByte(0x80 | (regAddr & 0x3F)); /* Устанавливаем бит RW в 1 для чтения */
+    ADXL345_LOCK(cc);
+    ADXL345_ReadBurst(startRegAddr, buffer, length);
+    ADXL345_UNLOCK(cc);
+}
 
-    /* Читаем данные */
-    data = SPI_ReadWriteByte(0x00); // Отправляем dummy byte для чтения данных
+/* Настройка вывода порта D как входа внешнего прерывания по переднему фронту */
+static void ADXL345_EnablePin(uint8_t pin)
+{
+    uint8_t cc;
 
-    ADXL345_CS_HIGH(); /* Деактивируем устройство */
+    /* Плавающий вход с внешним прерыванием (INT1/INT2 акселерометра — двухтактные выходы) */
+    PD_DDR &= (uint8_t)~pin;
+    PD_CR1 &= (uint8_t)~pin;
+    PD_CR2 |= pin;
 
-    return data;
+    /* EXTI_CR1 доступен для записи только при запрещенных прерываниях */
+    cc = IRQ_SAVE_DISABLE();
+    EXTI_CR1 = (EXTI_CR1 & (uint8_t)~ADXL345_EXTI_PD_MASK) | ADXL345_EXTI_PD_RISING;
+    adxl345_irq_on |= pin;
+    IRQ_RESTORE(cc);
 }
 
-void ADXL345_ReadMultBytes(uint8_t startRegAddr, uint8_t *buffer, uint8_t length)
+static void ADXL345_DisablePin(uint8_t pin)
 {
-    uint8_t i;
+    uint8_t cc;
 
-    ADXL345_CS_LOW(); /* Активируем устройство */
+    PD_CR2 &= (uint8_t)~pin;
+
+    cc = IRQ_SAVE_DISABLE();
+    adxl345_irq_on &= (uint8_t)~pin;
+    IRQ_RESTORE(cc);
+}
 
-    /* Отправляем адрес регистра с установленными битами чтения и многобайтной передачи (RW = 1, MB = 1) */
-    SPI_ReadWriteByte(0xC0 | (startRegAddr & 0x3F));
+/* Направление источников прерываний на INT1 или INT2 и их включение; остальные источники не меняются */
+static void ADXL345_EnableSources(uint8_t sources, uint8_t to_int2)
+{
+    uint8_t map = ADXL345_ReadReg(ADXL345_REG_INT_MAP);
+
+    map = to_int2 ? (map | sources) : (map & (uint8_t)~sources);
+    ADXL345_WriteReg(ADXL345_REG_INT_MAP, map);
+    ADXL345_WriteReg(ADXL345_REG_INT_ENABLE, ADXL345_ReadReg(ADXL345_REG_INT_ENABLE) | sources);
+}
 
-    /* Читаем данные */
-    for (i = 0; i < length; i++)
+static void ADXL345_DisableSources(uint8_t sources)
+{
+    ADXL345_WriteReg(ADXL345_REG_INT_ENABLE, ADXL345_ReadReg(ADXL345_REG_INT_ENABLE) & (uint8_t)~sources);
+}
+
+void ADXL345_FIFO_Start(uint8_t watermark)
+{
+    watermark &= ADXL345_FIFO_SAMPLES_MASK;
+    if (watermark == 0)
     {
-        buffer[i] = SPI_ReadWriteByte(0x00);
+        watermark = 1;
     }
 
-    ADXL345_CS_HIGH(); /* Деактивируем устройство */
-}
\ No newline at end of file
+    /* Режим bypass очищает FIFO; прерывания акселерометра отключены на время настройки */
+    ADXL345_FIFO_Stop();
+
+    adxl345_watermark = watermark;
+    adxl345_ring_head = 0;
+    adxl345_ring_tail = 0;
+    adxl345_dropped = 0;
+
+    adxl345_drain_pending = 0;
+    adxl345_int1_mode = ADXL345_INT1_FIFO;
+    ADXL345_EnablePin(ADXL345_INT1_PIN);
+
+    /* WATERMARK на INT1 */
+    ADXL345_EnableSources(ADXL345_INT_WATERMARK, 0);
+
+    /* Потоковый режим: INT1 поднимается, когда в FIFO накопится watermark выборок */
+    ADXL345_WriteReg(ADXL345_REG_FIFO_CTL, ADXL345_FIFO_STREAM | watermark);
+}
+
+void ADXL345_DataReady_Start(void)
+{
+    uint8_t buffer[6];
+
+    ADXL345_FIFO_Stop();
+
+    adxl345_ring_head = 0;
+    adxl345_ring_tail = 0;
+    adxl345_dropped = 0;
+
+    adxl345_int1_mode = ADXL345_INT1_DATA_READY;
+    ADXL345_EnablePin(ADXL345_INT1_PIN);
+
+    /* DATA_READY на INT1 */
+    ADXL345_EnableSources(ADXL345_INT_DATA_READY, 0);
+
+    /* Чтение готовой выборки опускает INT1, иначе передний фронт не появится */
+    ADXL345_ReadMultBytes(ADXL345_REG_DATAX0, buffer, sizeof(buffer));
+}
+
+void ADXL345_WaitSample(ADXL345_Sample_t *sample)
+{
+    /* Прерывание между проверкой и wfi лишь отложит пробуждение до следующего тика TIM4 (1 мс) */
+    while (!ADXL345_ReadSample(sample))
+    {
+        _asm("wfi");
+    }
+}
+
+void ADXL345_FIFO_Stop(void)
+{
+    ADXL345_DisableSources(ADXL345_INT_WATERMARK | ADXL345_INT_DATA_READY);
+    ADXL345_WriteReg(ADXL345_REG_FIFO_CTL, ADXL345_FIFO_BYPASS);
+
+    ADXL345_DisablePin(ADXL345_INT1_PIN);
+    adxl345_int1_mode = ADXL345_INT1_NONE;
+    adxl345_drain_pending = 0;
+}
+
+void ADXL345_Motion_Start(const ADXL345_MotionConfig_t *config)
+{
+    uint8_t power;
+
+    ADXL345_Motion_Stop();
+
+    ADXL345_WriteReg(ADXL345_REG_THRESH_ACT, config->act_threshold);
+    ADXL345_WriteReg(ADXL345_REG_THRESH_INACT, config->inact_threshold);
+    ADXL345_WriteReg(ADXL345_REG_TIME_INACT, config->inact_time);
+
+    /* AC-связь: порог отсчитывается от ускорения в момент начала отсчета, а не от нуля,
+       поэтому ориентация платы (сила тяжести) не влияет на обнаружение */
+    ADXL345_WriteReg(ADXL345_REG_ACT_INACT_CTL,
+                     ADXL345_ACT_AC | ADXL345_ACT_XYZ | ADXL345_INACT_AC | ADXL345_INACT_XYZ);
+
+    /* Связанный режим: активность ищется только после неактивности и наоборот */
+    power = ADXL345_POWER_MEASURE | ADXL345_POWER_LINK;
+    if (config->auto_sleep)
+    {
+        power |= ADXL345_POWER_AUTO_SLEEP;
+    }
+    ADXL345_WriteReg(ADXL345_REG_POWER_CTL, power);
+
+    adxl345_active = 1;
+    adxl345_auto_sleep = config->auto_sleep;
+    ADXL345_EnablePin(ADXL345_INT2_PIN);
+    ADXL345_EnableSources(ADXL345_INT_ACTIVITY | ADXL345_INT_INACTIVITY, 1);
+
+    /* Сброс защелкнутых событий: иначе INT2 останется в высоком уровне без переднего фронта */
+    ADXL345_ReadReg(ADXL345_REG_INT_SOURCE);
+}
+
+void ADXL345_Motion_Stop(void)
+{
+    uint8_t cc;
+
+    ADXL345_DisableSources(ADXL345_INT_ACTIVITY | ADXL345_INT_INACTIVITY);
+    ADXL345_WriteReg(ADXL345_REG_POWER_CTL, ADXL345_POWER_MEASURE);
+    if (!adxl345_events_on)
+    {
+        ADXL345_DisablePin(ADXL345_INT2_PIN);
+    }
+
+    cc = IRQ_SAVE_DISABLE();
+    adxl345_active = 1;
+    adxl345_auto_sleep = 0;
+    adxl345_period_us = adxl345_rate_period_us;
+    IRQ_RESTORE(cc);
+}
+
+uint8_t ADXL345_IsActive(void)
+{
+    return adxl345_active;
+}
+
+void ADXL345_Events_Start(const ADXL345_EventConfig_t *config)
+{
+    uint8_t sources = ADXL345_INT_SINGLE_TAP;
+
+    ADXL345_Events_Stop();
+
+    ADXL345_WriteReg(ADXL345_REG_THRESH_TAP, config->tap_threshold);
+    ADXL345_WriteReg(ADXL345_REG_DUR, config->tap_duration);
+    ADXL345_WriteReg(ADXL345_REG_LATENT, config->tap_latency);
+    ADXL345_WriteReg(ADXL345_REG_WINDOW, config->tap_window);
+    ADXL345_WriteReg(ADXL345_REG_TAP_AXES, config->tap_axes);
+    ADXL345_WriteReg(ADXL345_REG_THRESH_FF, config->ff_threshold);
+    ADXL345_WriteReg(ADXL345_REG_TIME_FF, config->ff_time);
+
+    if (config->tap_latency != 0 && config->tap_window != 0)
+    {
+        sources |= ADXL345_INT_DOUBLE_TAP;
+    }
+    if (config->ff_threshold != 0)
+    {
+        sources |= ADXL345_INT_FREE_FALL;
+    }
+
+    adxl345_event_head = 0;
+    adxl345_event_tail = 0;
+    adxl345_events_on = 1;
+
+    ADXL345_EnablePin(ADXL345_INT2_PIN);
+    ADXL345_EnableSources(sources, 1);
+
+    /* Сброс защелкнутых событий: иначе INT2 останется в высоком уровне без переднего фронта */
+    ADXL345_ReadReg(ADXL345_REG_INT_SOURCE);
+}
+
+void ADXL345_Events_Stop(void)
+{
+    ADXL345_DisableSources(ADXL345_INT_SINGLE_TAP | ADXL345_INT_DOUBLE_TAP | ADXL345_INT_FREE_FALL);
+    adxl345_events_on = 0;
+
+    /* INT2 остается включенным, пока на нем есть события активности */
+    if (!(ADXL345_ReadReg(ADXL345_REG_INT_ENABLE) & (ADXL345_INT_ACTIVITY | ADXL345_INT_INACTIVITY)))
+    {
+        ADXL345_DisablePin(ADXL345_INT2_PIN);
+    }
+}
+
+uint8_t ADXL345_ReadEvent(ADXL345_Event_t *event)
+{
+    uint8_t tail = adxl345_event_tail;
+
+    if (tail == adxl345_event_head)
+    {
+        return 0;
+    }
+
+    *event = adxl345_events[tail & (ADXL345_EVENT_QUEUE_SIZE - 1)];
+    adxl345_event_tail = tail + 1; /* Слот освобождается только после копирования */
+    return 1;
+}
+
+uint8_t ADXL345_ReadSample(ADXL345_Sample_t *sample)
+{
+    uint8_t tail;
+
+    if (adxl345_drain_pending)
+    {
+        ADXL345_FinishDrain();
+    }
+
+    tail = adxl345_ring_tail;
+    if (tail == adxl345_ring_head)
+    {
+        return 0;
+    }
+
+    *sample = adxl345_ring[tail & (ADXL345_RING_SIZE - 1)];
+    adxl345_ring_tail = tail + 1; /* Слот освобождается только после копирования */
+    return 1;
+}
+
+uint8_t ADXL345_Available(void)
+{
+    return (uint8_t)(adxl345_ring_head - adxl345_ring_tail);
+}
+
+uint16_t ADXL345_GetDropped(void)
+{
+    uint16_t dropped;
+    uint8_t cc;
+
+    cc = IRQ_SAVE_DISABLE();
+    dropped = adxl345_dropped;
+    IRQ_RESTORE(cc);
+
+    return dropped;
+}
+
+/* Постановка события в очередь; при полной очереди новое событие отбрасывается */
+static void ADXL345_PushEvent(uint8_t type, uint8_t axes, uint32_t time_ms)
+{
+    ADXL345_Event_t *event;
+    uint8_t head = adxl345_event_head;
+
+    if ((uint8_t)(head - adxl345_event_tail) >= ADXL345_EVENT_QUEUE_SIZE)
+    {
+        return;
+    }
+
+    event = &adxl345_events[head & (ADXL345_EVENT_QUEUE_SIZE - 1)];
+    event->type = type;
+    event->axes = axes;
+    event->time_ms = time_ms;
+    adxl345_event_head = head + 1;
+}
+
+/* События INT2: чтение INT_SOURCE снимает защелкнутые флаги и опускает вывод */
+static void ADXL345_ServiceInt2(void)
+{
+    uint8_t status = 0;
+    uint8_t source;
+    uint32_t time_ms;
+
+    /* Источник удара нужно прочитать до сброса прерывания */
+    if (adxl345_events_on)
+    {
+        status = ADXL345_ReadRegRaw(ADXL345_REG_ACT_TAP_STATUS);
+    }
+    source = ADXL345_ReadRegRaw(ADXL345_REG_INT_SOURCE);
+
+    /* В режиме автосна частота выдачи меняется вместе с состоянием: от периода зависят отметки времени FIFO */
+    if (source & ADXL345_INT_INACTIVITY)
+    {
+        adxl345_active = 0;
+        if (adxl345_auto_sleep)
+        {
+            adxl345_period_us = ADXL345_SLEEP_PERIOD_US;
+        }
+    }
+    if (source & ADXL345_INT_ACTIVITY)
+    {
+        adxl345_active = 1;
+        adxl345_period_us = adxl345_rate_period_us;
+    }
+
+    if (!adxl345_events_on)
+    {
+        return;
+    }
+
+    /* Журнал хранит миллисекунды: микросекундная отметка переполняется через 71 минуту */
+    time_ms = TIM4_GetMillis();
+
+    /* Второй удар двойного также отмечается как одиночный: записывается одно событие */
+    if (source & ADXL345_INT_DOUBLE_TAP)
+    {
+        ADXL345_PushEvent(ADXL345_INT_DOUBLE_TAP, status & ADXL345_TAP_XYZ, time_ms);
+    }
+    else if (source & ADXL345_INT_SINGLE_TAP)
+    {
+        ADXL345_PushEvent(ADXL345_INT_SINGLE_TAP, status & ADXL345_TAP_XYZ, time_ms);
+    }
+    if (source & ADXL345_INT_FREE_FALL)
+    {
+        ADXL345_PushEvent(ADXL345_INT_FREE_FALL, 0, time_ms);
+    }
+}
+
+@far @interrupt void ADXL345_IRQHandler(void)
+{
+    /* EXTI порта D общий для обоих выводов: обслуживаются все, находящиеся в высоком уровне */
+    uint8_t pins = PD_IDR & adxl345_irq_on;
+
+    if (pins & ADXL345_INT2_PIN)
+    {
+        ADXL345_ServiceInt2();
+    }
+
+    if (pins & ADXL345_INT1_PIN)
+    {
+        if (adxl345_int1_mode == ADXL345_INT1_FIFO)
+        {
+            /* Одна порция по порогу, чтобы не задерживать TIM4; остаток выгружает ADXL345_ReadSample */
+            adxl345_drain_pending = ADXL345_DrainFifo(1, adxl345_watermark);
+        }
+        else if (adxl345_int1_mode == ADXL345_INT1_DATA_READY)
+        {
+            ADXL345_CaptureSample();
+        }
+    }
+}
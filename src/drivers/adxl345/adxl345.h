@@ -58,9 +58,174 @@
 
 /* Определение констант */
 #define ADXL345_DEVICE_ID 0xE5 /**< @brief Ожидаемый идентификатор устройства */
+#define ADXL345_SPI_MAX_HZ 5000000UL /**< @brief Максимальная частота SCK по документации */
 
 /** @} */ // end of ADXL345_CONSTANTS
 
+/**
+ * @defgroup ADXL345_INT Биты регистров INT_ENABLE, INT_MAP и INT_SOURCE
+ * @{
+ */
+#define ADXL345_INT_DATA_READY 0x80 /**< @brief Готовы новые данные */
+#define ADXL345_INT_SINGLE_TAP 0x40 /**< @brief Одиночный удар */
+#define ADXL345_INT_DOUBLE_TAP 0x20 /**< @brief Двойной удар */
+#define ADXL345_INT_ACTIVITY 0x10   /**< @brief Активность */
+#define ADXL345_INT_INACTIVITY 0x08 /**< @brief Неактивность */
+#define ADXL345_INT_FREE_FALL 0x04  /**< @brief Свободное падение */
+#define ADXL345_INT_WATERMARK 0x02  /**< @brief В FIFO накоплено не менее порогового числа выборок */
+#define ADXL345_INT_OVERRUN 0x01    /**< @brief Перезапись непрочитанных данных */
+/** @} */ // end of ADXL345_INT
+
+/**
+ * @defgroup ADXL345_FIFO Параметры FIFO
+ * @{
+ */
+#define ADXL345_FIFO_BYPASS 0x00       /**< @brief FIFO_CTL: FIFO отключен (запись очищает FIFO) */
+#define ADXL345_FIFO_STREAM 0x80       /**< @brief FIFO_CTL: потоковый режим, старые выборки вытесняются */
+#define ADXL345_FIFO_SAMPLES_MASK 0x1F /**< @brief FIFO_CTL: порог (watermark) в выборках */
+#define ADXL345_FIFO_ENTRIES_MASK 0x3F /**< @brief FIFO_STATUS: число выборок в FIFO */
+#define ADXL345_FIFO_DEPTH 32          /**< @brief Глубина FIFO в выборках */
+
+/** @brief Порог FIFO по умолчанию: половина глубины, вторая половина — запас на задержку обработчика */
+#ifndef ADXL345_FIFO_WATERMARK
+#define ADXL345_FIFO_WATERMARK 16
+#endif
+
+/** @brief Размер кольцевого буфера выборок (степень двойки, не меньше глубины FIFO) */
+#ifndef ADXL345_RING_SIZE
+#define ADXL345_RING_SIZE 32
+#endif
+/** @} */ // end of ADXL345_FIFO
+
+/**
+ * @enum ADXL345_DataRate_t
+ * @brief Частота выдачи данных (ODR), код поля Rate регистра BW_RATE
+ *
+ * Частота удваивается с каждым кодом: 0,10 Гц (0x00) ... 3200 Гц (0x0F).
+ * Для 800 Гц и выше рекомендуется режим FIFO (@ref ADXL345_FIFO_Start).
+ */
+typedef enum
+{
+    ADXL345_RATE_0_10 = 0x00, /**< 0,10 Гц */
+    ADXL345_RATE_0_20 = 0x01, /**< 0,20 Гц */
+    ADXL345_RATE_0_39 = 0x02, /**< 0,39 Гц */
+    ADXL345_RATE_0_78 = 0x03, /**< 0,78 Гц */
+    ADXL345_RATE_1_56 = 0x04, /**< 1,56 Гц */
+    ADXL345_RATE_3_13 = 0x05, /**< 3,13 Гц */
+    ADXL345_RATE_6_25 = 0x06, /**< 6,25 Гц */
+    ADXL345_RATE_12_5 = 0x07, /**< 12,5 Гц */
+    ADXL345_RATE_25 = 0x08,   /**< 25 Гц */
+    ADXL345_RATE_50 = 0x09,   /**< 50 Гц */
+    ADXL345_RATE_100 = 0x0A,  /**< 100 Гц */
+    ADXL345_RATE_200 = 0x0B,  /**< 200 Гц */
+    ADXL345_RATE_400 = 0x0C,  /**< 400 Гц */
+    ADXL345_RATE_800 = 0x0D,  /**< 800 Гц */
+    ADXL345_RATE_1600 = 0x0E, /**< 1600 Гц */
+    ADXL345_RATE_3200 = 0x0F  /**< 3200 Гц */
+} ADXL345_DataRate_t;
+
+/**
+ * @enum ADXL345_Range_t
+ * @brief Диапазон измерений, поле Range регистра DATA_FORMAT
+ *
+ * В режиме Full Resolution цена отсчета 3,9 мг/LSB во всех диапазонах.
+ */
+typedef enum
+{
+    ADXL345_RANGE_2G = 0x00,  /**< ±2g */
+    ADXL345_RANGE_4G = 0x01,  /**< ±4g */
+    ADXL345_RANGE_8G = 0x02,  /**< ±8g */
+    ADXL345_RANGE_16G = 0x03  /**< ±16g */
+} ADXL345_Range_t;
+
+/** @brief DATA_FORMAT: полное разрешение (3,9 мг/LSB) */
+#define ADXL345_FORMAT_FULL_RES 0x08
+
+/**
+ * @defgroup ADXL345_MOTION Биты регистров ACT_INACT_CTL и POWER_CTL
+ * @{
+ */
+#define ADXL345_ACT_AC 0x80          /**< @brief Активность: AC-связь (относительно ускорения в начале отсчета) */
+#define ADXL345_ACT_XYZ 0x70         /**< @brief Активность: оси X, Y, Z */
+#define ADXL345_INACT_AC 0x08        /**< @brief Неактивность: AC-связь */
+#define ADXL345_INACT_XYZ 0x07       /**< @brief Неактивность: оси X, Y, Z */
+#define ADXL345_POWER_LINK 0x20      /**< @brief Связанный режим активности/неактивности */
+#define ADXL345_POWER_AUTO_SLEEP 0x10 /**< @brief Автоматический переход в сон при неактивности */
+#define ADXL345_POWER_MEASURE 0x08   /**< @brief Режим измерений */
+/** @} */ // end of ADXL345_MOTION
+
+/**
+ * @struct ADXL345_MotionConfig_t
+ * @brief Параметры обнаружения активности и неактивности
+ */
+typedef struct
+{
+    uint8_t act_threshold;   /**< Порог активности, 62,5 мг/LSB */
+    uint8_t inact_threshold; /**< Порог неактивности, 62,5 мг/LSB */
+    uint8_t inact_time;      /**< Время ниже порога до события неактивности, с */
+    uint8_t auto_sleep;      /**< 1 — датчик сам переходит в режим сна (8 Гц) при неактивности */
+} ADXL345_MotionConfig_t;
+
+/**
+ * @defgroup ADXL345_TAP Биты регистров TAP_AXES и ACT_TAP_STATUS
+ * @{
+ */
+#define ADXL345_TAP_SUPPRESS 0x08 /**< @brief TAP_AXES: подавление двойного удара при ускорении выше порога между ударами */
+#define ADXL345_TAP_X 0x04        /**< @brief Ось X участвует в обнаружении удара / источник удара */
+#define ADXL345_TAP_Y 0x02        /**< @brief Ось Y участвует в обнаружении удара / источник удара */
+#define ADXL345_TAP_Z 0x01        /**< @brief Ось Z участвует в обнаружении удара / источник удара */
+#define ADXL345_TAP_XYZ 0x07      /**< @brief Все оси */
+/** @} */ // end of ADXL345_TAP
+
+/** @brief Размер очереди событий (степень двойки) */
+#ifndef ADXL345_EVENT_QUEUE_SIZE
+#define ADXL345_EVENT_QUEUE_SIZE 8
+#endif
+
+/**
+ * @struct ADXL345_EventConfig_t
+ * @brief Параметры встроенных детекторов удара и свободного падения
+ *
+ * Нулевые значения tap_latency и tap_window отключают обнаружение двойного удара,
+ * нулевой ff_threshold — свободного падения.
+ */
+typedef struct
+{
+    uint8_t tap_threshold; /**< THRESH_TAP: порог удара, 62,5 мг/LSB */
+    uint8_t tap_duration;  /**< DUR: наибольшая длительность удара, 625 мкс/LSB */
+    uint8_t tap_latency;   /**< LATENT: пауза после первого удара, 1,25 мс/LSB */
+    uint8_t tap_window;    /**< WINDOW: окно ожидания второго удара, 1,25 мс/LSB */
+    uint8_t tap_axes;      /**< TAP_AXES: оси и подавление (@ref ADXL345_TAP) */
+    uint8_t ff_threshold;  /**< THRESH_FF: порог свободного падения, 62,5 мг/LSB */
+    uint8_t ff_time;       /**< TIME_FF: наименьшая длительность падения, 5 мс/LSB */
+} ADXL345_EventConfig_t;
+
+/**
+ * @struct ADXL345_Event_t
+ * @brief Событие встроенного детектора
+ */
+typedef struct
+{
+    uint8_t type;       /**< @ref ADXL345_INT_SINGLE_TAP, @ref ADXL345_INT_DOUBLE_TAP или @ref ADXL345_INT_FREE_FALL */
+    uint8_t axes;       /**< Оси-источники удара (@ref ADXL345_TAP), для падения — 0 */
+    uint32_t time_ms;   /**< Момент обработки прерывания, мс с момента запуска */
+} ADXL345_Event_t;
+
+/**
+ * @struct ADXL345_Sample_t
+ * @brief Выборка ускорения по трем осям (сырые отсчеты) с отметкой времени
+ *
+ * В режиме DATA_READY отметка ставится в момент прерывания. При выгрузке FIFO время
+ * самой новой выборки равно моменту чтения, более старые отстоят от нее на период выдачи данных.
+ */
+typedef struct
+{
+    int16_t x;          /**< Ось X */
+    int16_t y;          /**< Ось Y */
+    int16_t z;          /**< Ось Z */
+    uint32_t timestamp; /**< Момент измерения, мкс (@ref TIM4_GetMicros) */
+} ADXL345_Sample_t;
+
 /* Прототипы функций */
 
 /**
@@ -104,6 +269,33 @@
  */
 uint8_t ADXL345_Init(void);
 
+/**
+ * @brief Установка частоты выдачи данных
+ *
+ * Записывает BW_RATE (режим пониженного потребления выключен) и обновляет период,
+ * по которому восстанавливаются отметки времени выборок из FIFO.
+ *
+ * @param rate Частота выдачи данных
+ */
+void ADXL345_SetDataRate(ADXL345_DataRate_t rate);
+
+/**
+ * @brief Период выдачи данных при текущей частоте, мкс
+ *
+ * В покое с автосном (@ref ADXL345_MotionConfig_t.auto_sleep) — период режима сна (8 Гц).
+ */
+uint32_t ADXL345_GetSamplePeriod(void);
+
+/**
+ * @brief Установка диапазона измерений
+ *
+ * Записывает DATA_FORMAT: 4-проводный SPI, активный высокий уровень INT1/INT2,
+ * полное разрешение, выравнивание вправо.
+ *
+ * @param range Диапазон измерений
+ */
+void ADXL345_SetRange(ADXL345_Range_t range);
+
 /**
  * @brief Чтение данных ускорения с акселерометра ADXL345
  *
@@ -142,4 +334,118 @@ uint8_t ADXL345_ReadReg(uint8_t regAddr);
  */
 void ADXL345_ReadMultBytes(uint8_t startRegAddr, uint8_t *buffer, uint8_t length);
 
+/**
+ * @brief Запуск потокового режима FIFO с прерыванием по порогу
+ *
+ * Очищает FIFO, направляет прерывание WATERMARK на вывод INT1 (PD3, EXTI порта D, передний фронт)
+ * и включает потоковый режим. Обработчик прерывания выгружает в кольцевой буфер одну порцию
+ * размером с порог; если в FIFO осталось не меньше порога выборок, выгрузку продолжает
+ * @ref ADXL345_ReadSample в основном цикле. Выборки забираются через @ref ADXL345_ReadSample.
+ *
+ * После запуска функции драйвера, обращающиеся к SPI из основного цикла, запрещают прерывания
+ * на время обмена и не должны вызываться из обработчиков прерываний.
+ *
+ * @param watermark Порог FIFO в выборках (1..31)
+ */
+void ADXL345_FIFO_Start(uint8_t watermark);
+
+/**
+ * @brief Остановка FIFO и прерывания INT1
+ *
+ * Отключает также режим @ref ADXL345_DataReady_Start.
+ */
+void ADXL345_FIFO_Stop(void);
+
+/**
+ * @brief Запуск выборки по прерыванию DATA_READY
+ *
+ * FIFO отключается, прерывание DATA_READY направляется на INT1 (PD3). Обработчик читает
+ * каждую новую выборку сразу после ее готовности, ставит отметку времени с разрешением
+ * одного отсчета TIM4 и кладет ее в кольцевой буфер. Ограничения на вызовы из основного
+ * цикла — как у @ref ADXL345_FIFO_Start. Остановка — @ref ADXL345_FIFO_Stop.
+ */
+void ADXL345_DataReady_Start(void);
+
+/**
+ * @brief Ожидание выборки в режиме сна
+ *
+ * Пока кольцевой буфер пуст, ядро останавливается командой wfi и просыпается по любому
+ * прерыванию (новая выборка, системный тик TIM4).
+ *
+ * @param[out] sample Выборка
+ */
+void ADXL345_WaitSample(ADXL345_Sample_t *sample);
+
+/**
+ * @brief Запуск обнаружения активности и неактивности
+ *
+ * Настраивает пороги и время, связанный режим (POWER_CTL.LINK) и, по выбору, автоматический
+ * сон датчика. События ACTIVITY и INACTIVITY направляются на вывод INT2 (PD2, EXTI порта D),
+ * их обработчик переключает состояние, возвращаемое @ref ADXL345_IsActive.
+ *
+ * @param[in] config Параметры обнаружения
+ */
+void ADXL345_Motion_Start(const ADXL345_MotionConfig_t *config);
+
+/**
+ * @brief Остановка обнаружения активности и неактивности
+ */
+void ADXL345_Motion_Stop(void);
+
+/**
+ * @brief Состояние движения
+ *
+ * @retval 1 Устройство в движении (или обнаружение не запущено)
+ * @retval 0 Устройство неподвижно дольше заданного времени
+ */
+uint8_t ADXL345_IsActive(void);
+
+/**
+ * @brief Запуск детекторов одиночного и двойного удара и свободного падения
+ *
+ * Записывает параметры детекторов и направляет события на вывод INT2 (PD2). Обработчик
+ * прерывания читает ACT_TAP_STATUS и INT_SOURCE и кладет событие с отметкой времени в очередь
+ * на @ref ADXL345_EVENT_QUEUE_SIZE элементов. Детекторы работают внутри датчика, процессор
+ * занят только при наступлении события.
+ *
+ * @param[in] config Параметры детекторов
+ */
+void ADXL345_Events_Start(const ADXL345_EventConfig_t *config);
+
+/**
+ * @brief Остановка детекторов удара и свободного падения
+ */
+void ADXL345_Events_Stop(void);
+
+/**
+ * @brief Извлечение самого старого события из очереди
+ *
+ * @param[out] event Событие
+ * @retval 1 Событие извлечено
+ * @retval 0 Очередь пуста
+ */
+uint8_t ADXL345_ReadEvent(ADXL345_Event_t *event);
+
+/**
+ * @brief Извлечение самой старой выборки из кольцевого буфера
+ *
+ * Если обработчик прерывания не успел выгрузить FIFO ниже порога, сначала продолжает выгрузку
+ * (до @c ADXL345_DRAIN_ROUNDS порций, каждая при запрещенных прерываниях).
+ *
+ * @param[out] sample Выборка
+ * @retval 1 Выборка извлечена
+ * @retval 0 Буфер пуст
+ */
+uint8_t ADXL345_ReadSample(ADXL345_Sample_t *sample);
+
+/**
+ * @brief Количество выборок в кольцевом буфере
+ */
+uint8_t ADXL345_Available(void);
+
+/**
+ * @brief Количество выборок, потерянных из-за переполнения кольцевого буфера
+ */
+uint16_t ADXL345_GetDropped(void);
+
 #endif /* ADXL345_H */
\ No newline at end of file
@@ -0,0 +1,13 @@
+/**
+ * @file clk.c
+ * @brief Реализация настройки тактирования ядра
+ */
+
+#include "clk.h"
+#include "my_iostm8s103.h"
+
+void CLK_Init(void)
+{
+    /* HSIDIV[4:3] — делитель HSI, CPUDIV[2:0] = 0 — ядро на частоте f_MASTER */
+    CLK_CKDIVR = (CLK_HSIDIV << 3);
+}
@@ -0,0 +1,149 @@
+/**
+ * @file clk.h
+ * @brief Модуль тактирования: частота ядра и производные от нее параметры периферии
+ *
+ * Единственная настройка частоты — макрос @ref F_CPU. Из него на этапе компиляции вычисляются
+ * делитель HSI, параметры I2C (FREQR, CCR, TRISER), делители SPI, предделитель и период TIM4,
+ * а также константа программной задержки. Смена частоты не требует правки драйверов.
+ */
+
+#ifndef CLK_H
+#define CLK_H
+
+#include <stdint.h>
+
+/**
+ * @def F_CPU
+ * @brief Частота ядра и периферии (f_MASTER) в Гц
+ *
+ * Допустимые значения: 16, 8, 4 и 2 МГц (HSI 16 МГц с делителем 1, 2, 4 или 8).
+ * Может быть переопределена ключом компилятора.
+ */
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+/** @brief Частота внутреннего RC-генератора HSI в Гц */
+#define CLK_HSI_HZ 16000000UL
+
+/** @brief Код делителя HSIDIV для регистра CLK_CKDIVR */
+#if F_CPU == CLK_HSI_HZ
+#define CLK_HSIDIV 0
+#elif F_CPU == CLK_HSI_HZ / 2
+#define CLK_HSIDIV 1
+#elif F_CPU == CLK_HSI_HZ / 4
+#define CLK_HSIDIV 2
+#elif F_CPU == CLK_HSI_HZ / 8
+#define CLK_HSIDIV 3
+#else
+#error "F_CPU must be 16, 8, 4 or 2 MHz (HSI / 1, 2, 4, 8)"
+#endif
+
+/**
+ * @defgroup CLK_PCKENR1 Биты регистра CLK_PCKENR1 (тактирование периферии)
+ * @{
+ */
+#define CLK_PCKENR1_I2C (1 << 0)  /**< @brief Тактирование I2C */
+#define CLK_PCKENR1_SPI (1 << 1)  /**< @brief Тактирование SPI */
+#define CLK_PCKENR1_TIM4 (1 << 4) /**< @brief Тактирование TIM4 */
+/** @} */
+
+/**
+ * @defgroup CLK_I2C Параметры I2C
+ * @{
+ */
+
+/** @brief Значение I2C_FREQR: частота периферии в МГц */
+#define CLK_I2C_FREQR (F_CPU / 1000000UL)
+
+/** @brief Быстрый режим (400 кГц) требует f_MASTER не ниже 4 МГц */
+#define CLK_I2C_FAST_SUPPORTED (F_CPU >= 4000000UL)
+
+/** @brief CCR стандартного режима: T_high = T_low = CCR * T_MASTER, 100 кГц */
+#define CLK_I2C_CCR_STANDARD (F_CPU / (2UL * 100000UL))
+
+/** @brief CCR быстрого режима (DUTY = 0): T_low = 2 * T_high = 2 * CCR * T_MASTER, не более 400 кГц */
+#define CLK_I2C_CCR_FAST ((F_CPU + 3UL * 400000UL - 1) / (3UL * 400000UL))
+
+/** @brief TRISER стандартного режима: 1000 нс * f_MASTER + 1 */
+#define CLK_I2C_TRISER_STANDARD (CLK_I2C_FREQR + 1)
+
+/** @brief TRISER быстрого режима: 300 нс * f_MASTER + 1 (с округлением вверх) */
+#define CLK_I2C_TRISER_FAST ((CLK_I2C_FREQR * 3 + 9) / 10 + 1)
+
+/** @} */
+
+/**
+ * @brief Код делителя SPI (0..7 для f_MASTER / 2 ... f_MASTER / 256) для частоты не выше hz
+ *
+ * Константное выражение: вычисляется при компиляции.
+ */
+#define CLK_SPI_BR_CODE(hz)              \
+    ((F_CPU / 2UL <= (hz))     ? 0       \
+     : (F_CPU / 4UL <= (hz))   ? 1       \
+     : (F_CPU / 8UL <= (hz))   ? 2       \
+     : (F_CPU / 16UL <= (hz))  ? 3       \
+     : (F_CPU / 32UL <= (hz))  ? 4       \
+     : (F_CPU / 64UL <= (hz))  ? 5       \
+     : (F_CPU / 128UL <= (hz)) ? 6       \
+                               : 7)
+
+/**
+ * @brief Предел опроса флага SPI при SCK не выше hz: время одного байта с 10-кратным запасом
+ *
+ * Байт — 8 периодов SCK, то есть 8 * 2^(код + 1) тактов f_MASTER; опрос занимает ~8 тактов.
+ */
+#define CLK_SPI_TIMEOUT_LOOPS(hz) (10UL * (2UL << CLK_SPI_BR_CODE(hz)))
+
+/**
+ * @defgroup CLK_TIM4 Параметры TIM4 (системный тик 1 мс)
+ * @{
+ */
+
+/** @brief Показатель степени предделителя TIM4: наименьший, при котором период 1 мс умещается в 8 бит */
+#if F_CPU / 1000UL <= 256
+#define CLK_TIM4_PSCR 0
+#elif F_CPU / 2000UL <= 256
+#define CLK_TIM4_PSCR 1
+#elif F_CPU / 4000UL <= 256
+#define CLK_TIM4_PSCR 2
+#elif F_CPU / 8000UL <= 256
+#define CLK_TIM4_PSCR 3
+#elif F_CPU / 16000UL <= 256
+#define CLK_TIM4_PSCR 4
+#elif F_CPU / 32000UL <= 256
+#define CLK_TIM4_PSCR 5
+#elif F_CPU / 64000UL <= 256
+#define CLK_TIM4_PSCR 6
+#else
+#define CLK_TIM4_PSCR 7
+#endif
+
+/** @brief Количество отсчетов TIM4 за 1 мс */
+#define CLK_TIM4_TICKS_PER_MS ((F_CPU >> CLK_TIM4_PSCR) / 1000UL)
+
+/** @brief Длительность одного отсчета TIM4 в мкс (при допустимых F_CPU — ровно 4 мкс) */
+#define CLK_TIM4_US_PER_TICK (1000UL / CLK_TIM4_TICKS_PER_MS)
+
+/** @brief Значение TIM4_ARR: период переполнения 1 мс (счет от 0 до ARR включительно) */
+#define CLK_TIM4_ARR (CLK_TIM4_TICKS_PER_MS - 1)
+
+/** @} */
+
+/**
+ * @brief Итераций цикла программной задержки на 1 мс
+ *
+ * Одна итерация цикла в @ref delay занимает около 16 тактов (по осциллографу: 127 итераций на 1 мс
+ * при фактической частоте после сброса HSI / 8 = 2 МГц).
+ */
+#define CLK_DELAY_LOOPS_PER_MS (F_CPU / 1000UL / 16UL)
+
+/**
+ * @brief Настраивает тактирование ядра
+ *
+ * Выбирает HSI с делителем, соответствующим @ref F_CPU, и делитель CPU 1.
+ * Должна вызываться первой, до инициализации периферии.
+ */
+void CLK_Init(void);
+
+#endif /* CLK_H */
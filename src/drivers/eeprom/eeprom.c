@@ -5,86 +5,90 @@
 
 #include "eeprom.h"
 #include "i2c.h"
-#include "my_iostm8s103.h"
-#include "ssd1306.h"
-#include "my_str.h"
 #include "delay.h"
 
 uint8_t EEPROM_Write(uint16_t mem_address, const uint8_t *data, uint16_t size) {
-    uint16_t i;
-    uint8_t mem_high = (uint8_t)((mem_address >> 8) & 0xFF);
-    uint8_t mem_low = (uint8_t)(mem_address & 0xFF);
-
-    for (i = 0; i < size; ++i) {
-        /* Генерируем START */
-        I2C_Start();
-        while (!(I2C_SR1 & I2C_SR1_SB)); /* Ждем, пока START сгенерируется */
+    I2C_Transaction_t t;
+    uint16_t chunk;
+
+    t.address = EEPROM_I2C_ADDRESS & 0xFE; /* бит на запись */
+    t.header_len = 2;
+    t.rx_len = 0;
+    t.flags = 0;
+    t.priority = I2C_PRIORITY_HIGH;
+    t.callback = 0;
+
+    while (size) {
+        /* Запись не должна пересекать границу страницы: адрес внутри страницы циклически переполняется */
+        chunk = EEPROM_PAGE_SIZE - (mem_address & (EEPROM_PAGE_SIZE - 1));
+        if (chunk > size) {
+            chunk = size;
+        }
 
-        /* Отправляем адрес устройства */
-        I2C_WriteAddress(EEPROM_I2C_ADDRESS & 0xFE); /* бит на запись */
+        /* Старший и младший байты адреса памяти, затем данные страницы */
+        t.header[0] = (uint8_t)((mem_address >> 8) & 0xFF);
+        t.header[1] = (uint8_t)(mem_address & 0xFF);
+        t.tx = data;
+        t.tx_len = chunk;
 
-        /* Отправляем старший и младший байты адреса памяти */
-        I2C_WriteData(mem_high);
-        while (!(I2C_SR1 & I2C_SR1_TXE));
+        if (I2C_Transfer(&t) != I2C_OK) {
+            return 1;
+        }
 
-        I2C_WriteData(mem_low);
-        while (!(I2C_SR1 & I2C_SR1_TXE));
+        /* Дадим EEPROM время на запись страницы */
+        delay(EEPROM_WRITE_TIME_MS);
 
-        /* Отправляем данные */
-        I2C_WriteData(data[i]);
-        while (!(I2C_SR1 & I2C_SR1_TXE));
+        mem_address += chunk;
+        data += chunk;
+        size -= chunk;
+    }
 
-        /* Генерируем STOP */
-        I2C_Stop();
-        while (I2C_CR2 & I2C_CR2_STOP);
+    return 0;
+}
 
-        /* Дадим EEPROM время на запись */
-        delay(20);
+uint8_t EEPROM_WriteAsync(I2C_Transaction_t *t, uint16_t mem_address, const uint8_t *data, uint8_t size,
+                          I2C_Callback_t callback) {
+    if (t->status == I2C_XFER_PENDING) {
+        return 1;
+    }
+    if ((mem_address & (EEPROM_PAGE_SIZE - 1)) + size > EEPROM_PAGE_SIZE) {
+        return 1;
     }
 
+    t->address = EEPROM_I2C_ADDRESS & 0xFE;
+    t->header[0] = (uint8_t)((mem_address >> 8) & 0xFF);
+    t->header[1] = (uint8_t)(mem_address & 0xFF);
+    t->header_len = 2;
+    t->tx = data;
+    t->tx_len = size;
+    t->rx_len = 0;
+    t->flags = 0;
+    t->priority = I2C_PRIORITY_HIGH;
+    t->callback = callback;
+
+    I2C_Submit(t);
     return 0;
 }
 
 uint8_t EEPROM_Read(uint16_t mem_address, uint8_t *data, uint16_t size) {
-    uint8_t mem_high = (uint8_t)((mem_address >> 8) & 0xFF);
-    uint8_t mem_low = (uint8_t)(mem_address & 0xFF);
-		uint16_t i;
-
-    /* Генерируем START */
-    I2C_Start();
-    while (!(I2C_SR1 & I2C_SR1_SB)); /* Ждем, пока START сгенерируется */
-
-    /* Отправляем адрес устройства */
-    I2C_WriteAddress(EEPROM_I2C_ADDRESS & 0xFE); /* бит на запись */
-
-    /* Отправляем старший и младший байты адреса памяти */
-    I2C_WriteData(mem_high);
-    while (!(I2C_SR1 & I2C_SR1_TXE));
-
-    I2C_WriteData(mem_low);
-    while (!(I2C_SR1 & I2C_SR1_TXE));
-
-    /* Генерируем повторный START */
-    I2C_Start();
-    while (!(I2C_SR1 & I2C_SR1_SB));
-
-    /* Отправляем адрес устройства с битом на чтение */
-    I2C_WriteAddress(EEPROM_I2C_ADDRESS | 0x01);
-
-    /* Читаем данные */
-    for (i = 0; i < size; ++i) {
-        if (i == size - 1) {
-            /* Последний байт - NACK */
-            data[i] = I2C_ReadData_NACK();
-        } else {
-            /* Все остальные байты - ACK */
-            data[i] = I2C_ReadData_ACK();
-        }
-    }
+    I2C_Transaction_t t;
 
-    /* Генерируем STOP */
-    I2C_Stop();
-    while (I2C_CR2 & I2C_CR2_STOP);
+    if (size == 0) {
+        return 0;
+    }
 
-    return 0;
+    /* Запись адреса памяти, повторный START и последовательное чтение */
+    t.address = EEPROM_I2C_ADDRESS & 0xFE;
+    t.header[0] = (uint8_t)((mem_address >> 8) & 0xFF);
+    t.header[1] = (uint8_t)(mem_address & 0xFF);
+    t.header_len = 2;
+    t.tx = 0;
+    t.tx_len = 0;
+    t.rx = data;
+    t.rx_len = size;
+    t.flags = I2C_XFER_RESTART;
+    t.priority = I2C_PRIORITY_HIGH;
+    t.callback = 0;
+
+    return (I2C_Transfer(&t) == I2C_OK) ? 0 : 1;
 }
@@ -7,12 +7,30 @@
 #define EEPROM_H
 
 #include "stdint.h"
+#include "i2c.h"
 
 /** @brief Адрес EEPROM. */
 #define EEPROM_I2C_ADDRESS 0xA0 /**< 7-битный базовый адрес устройства (E0=E1=E2=0). */
 
+/** @brief Размер страницы M24512 в байтах. */
+#define EEPROM_PAGE_SIZE 128
+
+/** @brief Время внутреннего цикла записи страницы (tW) в миллисекундах. */
+#define EEPROM_WRITE_TIME_MS 5
+
+/** @defgroup EEPROM_Map Распределение памяти EEPROM (каждая область начинается с границы страницы)
+ * @{
+ */
+#define EEPROM_ADDR_SELFTEST 0x0000 /**< Тестовые данные самопроверки при запуске. */
+#define EEPROM_ADDR_CALIB 0x0080    /**< Запись калибровки акселерометра (calib.h). */
+#define EEPROM_ADDR_JOURNAL 0x0100  /**< Журнал событий. */
+/** @} */
+
 /**
  * @brief Запись данных в EEPROM.
+ *
+ * Данные записываются постранично: одна транзакция очереди I2C с высоким приоритетом
+ * на каждую затронутую страницу, после каждой — ожидание @ref EEPROM_WRITE_TIME_MS.
  * 
  * @param[in] mem_address Адрес в EEPROM, куда будут записаны данные (0x0000 - 0xFFFF).
  * @param[in] data Указатель на массив данных для записи.
@@ -24,6 +42,8 @@ uint8_t EEPROM_Write(uint16_t mem_address, const uint8_t *data, uint16_t size);
 
 /**
  * @brief Чтение данных из EEPROM.
+ *
+ * Выполняется одной транзакцией очереди I2C с повторным START.
  * 
  * @param[in] mem_address Адрес в EEPROM, откуда будут прочитаны данные (0x0000 - 0xFFFF).
  * @param[out] data Указатель на массив для сохранения прочитанных данных.
@@ -33,4 +53,22 @@ uint8_t EEPROM_Write(uint16_t mem_address, const uint8_t *data, uint16_t size);
  */
 uint8_t EEPROM_Read(uint16_t mem_address, uint8_t *data, uint16_t size);
 
+/**
+ * @brief Фоновая запись в пределах одной страницы.
+ * Транзакция ставится в очередь I2C с высоким приоритетом, функция не ждет ее завершения.
+ * Пока идет внутренний цикл записи (@ref EEPROM_WRITE_TIME_MS после завершения транзакции),
+ * EEPROM не подтверждает адрес, и следующая транзакция завершится с @ref I2C_ERR_NACK —
+ * выдерживать паузу должен вызывающий код.
+ *
+ * @param[out] t Дескриптор транзакции; должен существовать до завершения (статус != @ref I2C_XFER_PENDING).
+ * @param[in] mem_address Адрес в EEPROM.
+ * @param[in] data Данные; должны существовать до завершения транзакции.
+ * @param[in] size Количество байт; запись не должна пересекать границу страницы.
+ * @param[in] callback Вызывается из обработчика прерывания по завершении (может быть NULL).
+ *
+ * @return 0 если транзакция поставлена в очередь, 1 если дескриптор занят или запись пересекает страницу.
+ */
+uint8_t EEPROM_WriteAsync(I2C_Transaction_t *t, uint16_t mem_address, const uint8_t *data, uint8_t size,
+                          I2C_Callback_t callback);
+
 #endif /* EEPROM_H */
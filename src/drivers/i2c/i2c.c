@@ -4,8 +4,132 @@
  */
 
 #include "i2c.h"
+#include "tim4.h"
+#include "clk.h"
 #include "my_iostm8s103.h"
 
+/* Линии I2C на порту B (STM8S103: PB4 = SCL, PB5 = SDA, выходы с открытым стоком) */
+#define I2C_PIN_SCL (1 << 4)
+#define I2C_PIN_SDA (1 << 5)
+
+/* Фазы текущей транзакции */
+#define I2C_PHASE_WRITE 0 /* Передача заголовка и данных */
+#define I2C_PHASE_READ 1  /* Прием данных */
+
+/* Очереди транзакций по приоритетам: голова и хвост односвязного списка */
+static I2C_Transaction_t *i2c_queue_head[I2C_PRIORITY_COUNT];
+static I2C_Transaction_t *i2c_queue_tail[I2C_PRIORITY_COUNT];
+
+/* Транзакция, которую ведет обработчик прерывания, и ее состояние */
+static I2C_Transaction_t *volatile i2c_current = 0;
+static uint8_t i2c_phase;
+static uint8_t i2c_header_pos;
+static const uint8_t *i2c_tx;
+static uint16_t i2c_tx_left;
+static uint8_t *i2c_rx;
+static uint16_t i2c_rx_left;
+
+/* Шина захвачена блокирующими функциями (I2C_Start ... I2C_Stop) */
+static volatile uint8_t i2c_locked = 0;
+
+/* Первая ошибка блокирующей последовательности: после нее примитивы сразу возвращают ошибку до I2C_Stop */
+static I2C_Status_t i2c_sync_status = I2C_OK;
+static uint8_t i2c_sync_address;
+
+/* Счетчик событий прерывания: по отсутствию его изменения обнаруживается зависание транзакции */
+static volatile uint8_t i2c_progress = 0;
+
+/* Режим для повторной инициализации после восстановления шины */
+static I2C_Mode_t i2c_mode = I2C_FAST_MODE;
+
+/* Счетчики ошибок по устройствам */
+static I2C_DeviceStats_t i2c_stats[I2C_STATS_DEVICES];
+
+static I2C_DeviceStats_t *I2C_Stats(uint8_t address)
+{
+    uint8_t i;
+
+    address &= 0xFE;
+    for (i = 0; i < I2C_STATS_DEVICES; i++)
+    {
+        if (i2c_stats[i].address == address)
+        {
+            return &i2c_stats[i];
+        }
+        if (i2c_stats[i].address == 0)
+        {
+            i2c_stats[i].address = address; // Первое обращение к устройству — занимаем свободную запись
+            return &i2c_stats[i];
+        }
+    }
+    return &i2c_stats[I2C_STATS_DEVICES - 1]; // Переполнение таблицы: учитываем в последней записи
+}
+
+static void I2C_CountError(uint8_t address, I2C_Status_t status)
+{
+    I2C_DeviceStats_t *stats = I2C_Stats(address);
+
+    stats->errors++;
+    if (status == I2C_ERR_TIMEOUT)
+    {
+        stats->timeouts++;
+    }
+    stats->last_error = (uint8_t)status;
+}
+
+static I2C_Status_t I2C_DecodeError(uint8_t sr2)
+{
+    if (sr2 & I2C_SR2_BERR)
+    {
+        return I2C_ERR_BERR;
+    }
+    if (sr2 & I2C_SR2_ARLO)
+    {
+        return I2C_ERR_ARLO;
+    }
+    return I2C_ERR_NACK;
+}
+
+/* Ожидание флага SR1 с ограничением по числу опросов и проверкой ошибок SR2 */
+static I2C_Status_t I2C_WaitFlag(uint8_t flag)
+{
+    uint16_t budget = I2C_TIMEOUT_LOOPS;
+    uint8_t sr2;
+
+    while (!(I2C_SR1 & flag))
+    {
+        sr2 = I2C_SR2;
+        if (sr2 & (I2C_SR2_AF | I2C_SR2_ARLO | I2C_SR2_BERR))
+        {
+            I2C_SR2 = 0x00;
+            return I2C_DecodeError(sr2);
+        }
+        if (--budget == 0)
+        {
+            return I2C_ERR_TIMEOUT;
+        }
+    }
+    return I2C_OK;
+}
+
+/* Ожидание завершения STOP предыдущей транзакции */
+static void I2C_WaitStop(void)
+{
+    uint16_t budget = I2C_TIMEOUT_LOOPS;
+
+    while ((I2C_CR2 & I2C_CR2_STOP) && --budget)
+        ;
+}
+
+/* Полупериод SCL при восстановлении шины (~5 мкс) */
+static void I2C_BitDelay(void)
+{
+    volatile uint8_t i;
+
+    for (i = 0; i < I2C_RECOVERY_DELAY_LOOPS; i++)
+        ;
+}
+
 uint8_t I2C_Init(I2C_Mode_t mode)
 {
     uint16_t CCR;
@@ -13,27 +137,33 @@ uint8_t I2C_Init(I2C_Mode_t mode)
     uint8_t CCRH_Value;
     uint8_t TRISER_Value;
 
+#if !CLK_I2C_FAST_SUPPORTED
+    mode = I2C_STANDARD_MODE; // Быстрый режим недоступен при f_MASTER < 4 МГц
+#endif
+    i2c_mode = mode;
+
     /* Включаем тактирование периферии I2C */
-    CLK_PCKENR1 |= 0x02; // Бит 1 соответствует I2C в PCKENR1
+    CLK_PCKENR1 |= CLK_PCKENR1_I2C;
 
     /* Настраиваем частоту I2C */
-    I2C_FREQR = 16; // Частота тактирования 16 МГц
+    I2C_FREQR = (uint8_t)CLK_I2C_FREQR; // Частота тактирования в МГц
 
     /* Настраиваем параметры в зависимости от режима */
     if (mode == I2C_STANDARD_MODE)
     {
         /* Стандартный режим (100 кГц) */
-        CCRL_Value = 0x50;
-        CCRH_Value = 0x00;
-        TRISER_Value = 17;
+        CCR = (uint16_t)CLK_I2C_CCR_STANDARD;
+        CCRL_Value = (uint8_t)(CCR & 0xFF);          // Младшие 8 бит CCR
+        CCRH_Value = (uint8_t)((CCR >> 8) & 0x0F);   // Старшие биты CCR
+        TRISER_Value = (uint8_t)CLK_I2C_TRISER_STANDARD;
     }
     else
     { /* I2C_FAST_MODE */
         /* Быстрый режим (400 кГц) */
-        CCR = 13;                                                // Вычислено ранее
+        CCR = (uint16_t)CLK_I2C_CCR_FAST;
         CCRL_Value = (uint8_t)(CCR & 0xFF);                      // Младшие 8 бит CCR
         CCRH_Value = (uint8_t)((CCR >> 8) & 0x0F) | I2C_CCRH_FS; // Старшие биты CCR + бит FS (Fast Mode)
-        TRISER_Value = 6;
+        TRISER_Value = (uint8_t)CLK_I2C_TRISER_FAST;
     }
 
     /* Устанавливаем CCRL и CCRH */
@@ -43,8 +173,9 @@ uint8_t I2C_Init(I2C_Mode_t mode)
     /* Устанавливаем максимальное время нарастания */
     I2C_TRISER = TRISER_Value;
 
-    /* Сбрасываем регистр управления 1 */
+    /* Сбрасываем регистр управления 1 и запрещаем прерывания */
     I2C_CR1 = 0x00;
+    I2C_ITR = 0x00;
 
     /* Устанавливаем бит ACK в регистре CR2 */
     I2C_CR2 |= I2C_CR2_ACK;
@@ -60,45 +191,501 @@ uint8_t I2C_Init(I2C_Mode_t mode)
     return (I2C_CR1 & I2C_CR1_PE) ? 0 : 1;
 }
 
-void I2C_Start(void)
+I2C_Status_t I2C_Start(void)
 {
-    I2C_CR2 |= I2C_CR2_START; // Генерируем условие START
-    while (!(I2C_SR1 & I2C_SR1_SB))
-        ; // Ждем установки флага SB (Start Bit)
+    if (!i2c_locked)
+    {
+        I2C_Flush(); // Ждем, пока очередь транзакций освободит шину
+        i2c_locked = 1;
+        i2c_sync_status = I2C_OK;
+    }
+    if (i2c_sync_status != I2C_OK)
+    {
+        return i2c_sync_status;
+    }
+
+    I2C_CR2 |= I2C_CR2_START;                    // Генерируем условие START
+    i2c_sync_status = I2C_WaitFlag(I2C_SR1_SB); // Ждем установки флага SB (Start Bit)
+    return i2c_sync_status;
 }
 
-void I2C_Stop(void)
+I2C_Status_t I2C_Stop(void)
 {
+    I2C_Status_t status = i2c_sync_status;
+
     I2C_CR2 |= I2C_CR2_STOP; // Генерируем условие STOP
+
+    if (status != I2C_OK)
+    {
+        I2C_CountError(i2c_sync_address, status);
+        if (status != I2C_ERR_NACK)
+        {
+            I2C_RecoverBus(); // Шина в неизвестном состоянии
+        }
+    }
+
+    i2c_locked = 0;
+    i2c_sync_status = I2C_OK;
+    I2C_Submit(0); // Запускаем транзакции, поставленные в очередь за время блокировки
+    return status;
 }
 
-void I2C_WriteAddress(uint8_t address)
+I2C_Status_t I2C_WriteAddress(uint8_t address)
 {
-    I2C_DR = address; // Отправляем адрес
-    while (!(I2C_SR1 & I2C_SR1_ADDR))
-        ;          // Ждем установки флага ADDR
-    (void)I2C_SR3; // Читаем SR3 для сброса флага ADDR
+    i2c_sync_address = address;
+    if (i2c_sync_status != I2C_OK)
+    {
+        return i2c_sync_status;
+    }
+
+    I2C_DR = address;                              // Отправляем адрес
+    i2c_sync_status = I2C_WaitFlag(I2C_SR1_ADDR); // Ждем установки флага ADDR
+    (void)I2C_SR3;                                 // Читаем SR3 для сброса флага ADDR
+    return i2c_sync_status;
 }
 
-void I2C_WriteData(uint8_t data)
+I2C_Status_t I2C_WriteData(uint8_t data)
 {
-    I2C_DR = data; // Отправляем данные
-    while (!(I2C_SR1 & I2C_SR1_TXE))
-        ; // Ждем, пока TXE (регистр данных пуст)
+    if (i2c_sync_status != I2C_OK)
+    {
+        return i2c_sync_status;
+    }
+
+    I2C_DR = data;                                // Отправляем данные
+    i2c_sync_status = I2C_WaitFlag(I2C_SR1_TXE); // Ждем, пока TXE (регистр данных пуст)
+    return i2c_sync_status;
 }
 
 uint8_t I2C_ReadData_ACK(void)
 {
-    I2C_CR2 |= I2C_CR2_ACK; // Устанавливаем бит ACK
-    while (!(I2C_SR1 & I2C_SR1_RXNE))
-        ;          // Ждем установки флага RXNE
-    return I2C_DR; // Возвращаем полученные данные
+    if (i2c_sync_status != I2C_OK)
+    {
+        return 0;
+    }
+
+    I2C_CR2 |= I2C_CR2_ACK;                        // Устанавливаем бит ACK
+    i2c_sync_status = I2C_WaitFlag(I2C_SR1_RXNE); // Ждем установки флага RXNE
+    return I2C_DR;                                 // Возвращаем полученные данные
 }
 
 uint8_t I2C_ReadData_NACK(void)
 {
-    I2C_CR2 &= ~I2C_CR2_ACK; // Сбрасываем бит ACK
-    while (!(I2C_SR1 & I2C_SR1_RXNE))
-        ;          // Ждем установки флага RXNE
-    return I2C_DR; // Возвращаем полученные данные
+    if (i2c_sync_status != I2C_OK)
+    {
+        return 0;
+    }
+
+    I2C_CR2 &= ~I2C_CR2_ACK;                       // Сбрасываем бит ACK
+    i2c_sync_status = I2C_WaitFlag(I2C_SR1_RXNE); // Ждем установки флага RXNE
+    return I2C_DR;                                 // Возвращаем полученные данные
+}
+
+void I2C_RecoverBus(void)
+{
+    uint8_t i;
+
+    /* Отключаем периферию: линиями управляем вручную */
+    I2C_ITR = 0x00;
+    I2C_CR1 &= (uint8_t)~I2C_CR1_PE;
+
+    /* SCL и SDA — выходы с открытым стоком в отпущенном (высоком) состоянии */
+    PB_ODR |= I2C_PIN_SCL | I2C_PIN_SDA;
+    PB_CR1 &= (uint8_t)~(I2C_PIN_SCL | I2C_PIN_SDA);
+    PB_DDR |= I2C_PIN_SCL | I2C_PIN_SDA;
+    I2C_BitDelay();
+
+    /* До 9 тактов SCL, пока ведомое устройство не отпустит SDA */
+    for (i = 0; i < 9 && !(PB_IDR & I2C_PIN_SDA); i++)
+    {
+        PB_ODR &= (uint8_t)~I2C_PIN_SCL;
+        I2C_BitDelay();
+        PB_ODR |= I2C_PIN_SCL;
+        I2C_BitDelay();
+    }
+
+    /* Условие STOP: фронт SDA при высоком SCL */
+    PB_ODR &= (uint8_t)~I2C_PIN_SCL;
+    I2C_BitDelay();
+    PB_ODR &= (uint8_t)~I2C_PIN_SDA;
+    I2C_BitDelay();
+    PB_ODR |= I2C_PIN_SCL;
+    I2C_BitDelay();
+    PB_ODR |= I2C_PIN_SDA;
+    I2C_BitDelay();
+
+    /* Возвращаем линии периферии, программный сброс и повторная инициализация */
+    PB_DDR &= (uint8_t)~(I2C_PIN_SCL | I2C_PIN_SDA);
+    I2C_CR2 = I2C_CR2_SWRST;
+    I2C_CR2 = 0x00;
+    I2C_Init(i2c_mode);
+}
+
+const I2C_DeviceStats_t *I2C_GetDeviceStats(uint8_t address)
+{
+    uint8_t i;
+
+    address &= 0xFE;
+    for (i = 0; i < I2C_STATS_DEVICES; i++)
+    {
+        if (i2c_stats[i].address == address)
+        {
+            return &i2c_stats[i];
+        }
+    }
+    return 0;
+}
+
+/* Начинает обработку следующей транзакции из очереди. Вызывается с замаскированными прерываниями I2C. */
+static void I2C_StartNext(void)
+{
+    I2C_Transaction_t *t = 0;
+    uint8_t priority;
+
+    if (i2c_current || i2c_locked)
+    {
+        return;
+    }
+
+    for (priority = 0; priority < I2C_PRIORITY_COUNT; priority++)
+    {
+        t = i2c_queue_head[priority];
+        if (t)
+        {
+            i2c_queue_head[priority] = t->next;
+            break;
+        }
+    }
+    if (!t)
+    {
+        return;
+    }
+
+    i2c_current = t;
+    i2c_header_pos = 0;
+    i2c_tx = t->tx;
+    i2c_tx_left = t->tx_len;
+    i2c_rx = t->rx;
+    i2c_rx_left = t->rx_len;
+    i2c_phase = (t->header_len || t->tx_len) ? I2C_PHASE_WRITE : I2C_PHASE_READ;
+
+    I2C_WaitStop(); // Ждем завершения STOP предыдущей транзакции
+
+    I2C_ITR = I2C_ITR_ITERREN | I2C_ITR_ITEVTEN | I2C_ITR_ITBUFEN;
+    I2C_CR2 |= I2C_CR2_START; // Дальше транзакцию ведет обработчик прерывания
+}
+
+/* Завершает текущую транзакцию и без паузы запускает следующую */
+static void I2C_Finish(I2C_Status_t status)
+{
+    I2C_Transaction_t *t = i2c_current;
+
+    I2C_CR2 |= I2C_CR2_STOP;
+    I2C_ITR = 0x00;
+    i2c_current = 0;
+
+    if (status != I2C_OK)
+    {
+        I2C_CountError(t->address, status);
+        if (status != I2C_ERR_NACK)
+        {
+            I2C_RecoverBus(); // Тайм-аут, потеря арбитража или ошибка шины
+        }
+    }
+
+    t->status = status;
+    if (t->callback)
+    {
+        t->callback(t); // Обратный вызов может поставить в очередь новые транзакции
+    }
+
+    I2C_StartNext();
+}
+
+void I2C_Submit(I2C_Transaction_t *transaction)
+{
+    uint8_t priority;
+    uint8_t itr = I2C_ITR;
+
+    /* Очередь изменяется и обработчиком прерывания I2C: на время изменения маскируем только его.
+       Глобальный запрет не используется, так как функция вызывается и из обратных вызовов. */
+    I2C_ITR = 0x00;
+
+    if (transaction)
+    {
+        priority = transaction->priority < I2C_PRIORITY_COUNT ? transaction->priority : I2C_PRIORITY_COUNT - 1;
+        transaction->status = I2C_XFER_PENDING;
+        transaction->next = 0;
+        if (i2c_queue_head[priority])
+        {
+            i2c_queue_tail[priority]->next = transaction;
+        }
+        else
+        {
+            i2c_queue_head[priority] = transaction;
+        }
+        i2c_queue_tail[priority] = transaction;
+    }
+
+    if (i2c_current)
+    {
+        I2C_ITR = itr; // Текущая транзакция продолжается, новая будет запущена по ее завершении
+    }
+    else
+    {
+        I2C_StartNext();
+    }
+}
+
+/* Прерывает текущую транзакцию с ошибкой тайм-аута, если с проверки сторожа (progress) она не продвинулась */
+static void I2C_Abort(uint8_t progress)
+{
+    uint8_t stuck;
+    uint8_t cc;
+
+    /* Обработчик мог успеть завершить зависшую транзакцию и запустить следующую: повторная проверка
+       и маскирование I2C_ITR выполняются без прерываний, прерывать чужую транзакцию нельзя */
+    cc = IRQ_SAVE_DISABLE();
+    stuck = i2c_current && i2c_progress == progress;
+    if (stuck)
+    {
+        I2C_ITR = 0x00;
+    }
+    IRQ_RESTORE(cc);
+
+    if (stuck)
+    {
+        I2C_Finish(I2C_ERR_TIMEOUT);
+    }
+}
+
+/* Один шаг ожидания очереди: если обработчик прерывания не продвинулся за I2C_TIMEOUT_LOOPS шагов,
+   текущая транзакция прерывается. Задержка на каждый байт очереди ограничена. */
+static void I2C_WatchStep(uint8_t *last_progress, uint16_t *budget)
+{
+    if (i2c_progress != *last_progress)
+    {
+        *last_progress = i2c_progress;
+        *budget = I2C_TIMEOUT_LOOPS;
+    }
+    else if (--(*budget) == 0)
+    {
+        I2C_Abort(*last_progress);
+        *budget = I2C_TIMEOUT_LOOPS;
+    }
+}
+
+I2C_Status_t I2C_Transfer(I2C_Transaction_t *transaction)
+{
+    uint8_t attempt, last_progress;
+    uint16_t budget;
+
+    for (attempt = 0;; attempt++)
+    {
+        I2C_Submit(transaction);
+
+        last_progress = i2c_progress;
+        budget = I2C_TIMEOUT_LOOPS;
+        while (transaction->status == I2C_XFER_PENDING)
+        {
+            I2C_WatchStep(&last_progress, &budget); // Транзакцию выполняет обработчик прерывания
+        }
+
+        if (transaction->status == I2C_OK || attempt >= I2C_MAX_RETRIES)
+        {
+            return (I2C_Status_t)transaction->status;
+        }
+        I2C_Stats(transaction->address)->retries++;
+    }
+}
+
+void I2C_Flush(void)
+{
+    uint8_t last_progress = i2c_progress;
+    uint16_t budget = I2C_TIMEOUT_LOOPS;
+
+    while (I2C_IsBusy())
+    {
+        I2C_WatchStep(&last_progress, &budget);
+    }
+}
+
+void I2C_Service(void)
+{
+    static uint8_t last_progress;
+    static uint32_t last_change_ms;
+    uint32_t now = TIM4_GetMillis();
+
+    if (!i2c_current || i2c_progress != last_progress)
+    {
+        last_progress = i2c_progress;
+        last_change_ms = now;
+    }
+    else if (TIM4_ELAPSED(last_change_ms, now) >= I2C_XFER_TIMEOUT_MS)
+    {
+        I2C_Abort(last_progress);
+        last_change_ms = now;
+    }
+}
+
+uint8_t I2C_IsBusy(void)
+{
+    uint8_t priority;
+
+    if (i2c_current)
+    {
+        return 1;
+    }
+    for (priority = 0; priority < I2C_PRIORITY_COUNT; priority++)
+    {
+        if (i2c_queue_head[priority])
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+@far @interrupt void I2C_IRQHandler(void)
+{
+    I2C_Transaction_t *t = i2c_current;
+    uint8_t sr1 = I2C_SR1;
+    uint8_t sr2 = I2C_SR2;
+    I2C_Status_t status;
+
+    if (!t)
+    {
+        I2C_ITR = 0x00;
+        return;
+    }
+    i2c_progress++;
+
+    /* Ошибки: NACK, потеря арбитража, ошибка шины */
+    if (sr2 & (I2C_SR2_AF | I2C_SR2_ARLO | I2C_SR2_BERR))
+    {
+        I2C_SR2 = 0x00;
+        I2C_Finish(I2C_DecodeError(sr2));
+        return;
+    }
+
+    /* START сгенерирован — отправляем адрес с битом направления */
+    if (sr1 & I2C_SR1_SB)
+    {
+        I2C_DR = (i2c_phase == I2C_PHASE_READ) ? (uint8_t)(t->address | 0x01) : t->address;
+        return;
+    }
+
+    /* Адрес подтвержден */
+    if (sr1 & I2C_SR1_ADDR)
+    {
+        if (i2c_phase == I2C_PHASE_READ && i2c_rx_left == 1)
+        {
+            /* Единственный байт: NACK и STOP необходимо задать до сброса ADDR */
+            I2C_CR2 &= (uint8_t)~I2C_CR2_ACK;
+            (void)I2C_SR3;
+            I2C_CR2 |= I2C_CR2_STOP;
+        }
+        else
+        {
+            if (i2c_phase == I2C_PHASE_READ && i2c_rx_left == 3)
+            {
+                I2C_ITR &= (uint8_t)~I2C_ITR_ITBUFEN; // Три последних байта — по BTF
+            }
+            I2C_CR2 |= I2C_CR2_ACK;
+            (void)I2C_SR3; // Сброс ADDR, далее придет TXE или RXNE
+        }
+        return;
+    }
+
+    if (i2c_phase == I2C_PHASE_READ)
+    {
+        if (!(I2C_ITR & I2C_ITR_ITBUFEN))
+        {
+            /* Чтение N > 2 байт по RM0016: NACK и STOP задаются по BTF, когда шина остановлена
+               растяжением SCL, поэтому задержка обработчика не приводит к лишнему байту */
+            if (!(sr1 & I2C_SR1_BTF))
+            {
+                return;
+            }
+            if (i2c_rx_left == 3)
+            {
+                /* DataN-2 в DR, DataN-1 в сдвиговом регистре: на DataN ответим NACK */
+                I2C_CR2 &= (uint8_t)~I2C_CR2_ACK;
+                *i2c_rx++ = I2C_DR;
+                i2c_rx_left--;
+                return;
+            }
+
+            /* DataN-1 в DR, DataN в сдвиговом регистре */
+            I2C_CR2 |= I2C_CR2_STOP;
+            *i2c_rx++ = I2C_DR;
+            status = I2C_WaitFlag(I2C_SR1_RXNE); // DataN переходит в DR сразу после чтения DataN-1
+            if (status != I2C_OK)
+            {
+                I2C_Finish(status);
+                return;
+            }
+            *i2c_rx = I2C_DR;
+            i2c_rx_left = 0;
+            I2C_Finish(I2C_OK);
+            return;
+        }
+
+        if (sr1 & I2C_SR1_RXNE)
+        {
+            *i2c_rx++ = I2C_DR;
+            if (--i2c_rx_left == 3)
+            {
+                I2C_ITR &= (uint8_t)~I2C_ITR_ITBUFEN; // Три последних байта — по BTF
+            }
+            else if (i2c_rx_left == 1)
+            {
+                /* Два байта: последний уже принимается, ответим на него NACK и завершим STOP */
+                I2C_CR2 &= (uint8_t)~I2C_CR2_ACK;
+                I2C_CR2 |= I2C_CR2_STOP;
+            }
+            else if (i2c_rx_left == 0)
+            {
+                I2C_Finish(I2C_OK);
+            }
+        }
+        return;
+    }
+
+    if (sr1 & I2C_SR1_TXE)
+    {
+        if (i2c_header_pos < t->header_len)
+        {
+            I2C_DR = t->header[i2c_header_pos++];
+        }
+        else if (i2c_tx_left)
+        {
+            I2C_DR = *i2c_tx++;
+            i2c_tx_left--;
+        }
+        else
+        {
+            /* Все байты в сдвиговом регистре: ждем BTF без прерываний по TXE */
+            I2C_ITR &= (uint8_t)~I2C_ITR_ITBUFEN;
+            if (!(sr1 & I2C_SR1_BTF))
+            {
+                return;
+            }
+
+            if (i2c_rx_left == 0)
+            {
+                I2C_Finish(I2C_OK);
+                return;
+            }
+
+            /* Переход к фазе чтения: повторный START либо STOP и новый START */
+            if (!(t->flags & I2C_XFER_RESTART))
+            {
+                I2C_CR2 |= I2C_CR2_STOP;
+                I2C_WaitStop();
+            }
+            i2c_phase = I2C_PHASE_READ;
+            I2C_CR2 |= I2C_CR2_START;
+            I2C_ITR |= I2C_ITR_ITBUFEN;
+        }
+    }
 }
@@ -9,6 +9,7 @@
 #define I2C_H
 
 #include <stdint.h> /* Для типов uint8_t и т.д. */
+#include "clk.h"      /* F_CPU */
 
 /** @defgroup I2C_CR1_Bit_Masks Битовые маски регистра I2C Control Register 1 (CR1)
  * @{
@@ -32,6 +33,9 @@
 /** @brief Включение подтверждения (ACK) */
 #define I2C_CR2_ACK ((uint8_t)0x04)
 
+/** @brief Программный сброс периферии */
+#define I2C_CR2_SWRST ((uint8_t)0x80)
+
 /** @} */
 
 /** @defgroup I2C_SR1_Bit_Masks Битовые маски регистра I2C Status Register 1 (SR1)
@@ -44,6 +48,9 @@
 /** @brief Адрес отправлен/совпадение адреса */
 #define I2C_SR1_ADDR ((uint8_t)0x02)
 
+/** @brief Передача байта завершена (BTF) */
+#define I2C_SR1_BTF ((uint8_t)0x04)
+
 /** @brief Регистр приёма не пуст (RXNE) */
 #define I2C_SR1_RXNE ((uint8_t)0x40)
 
@@ -52,6 +59,45 @@
 
 /** @} */
 
+/** @defgroup I2C_SR2_Bit_Masks Битовые маски регистра I2C Status Register 2 (SR2)
+ * @{
+ */
+
+/** @brief Ошибка шины (неожиданное условие START/STOP) */
+#define I2C_SR2_BERR ((uint8_t)0x01)
+
+/** @brief Потеря арбитража */
+#define I2C_SR2_ARLO ((uint8_t)0x02)
+
+/** @brief Отсутствие подтверждения (NACK) */
+#define I2C_SR2_AF ((uint8_t)0x04)
+
+/** @} */
+
+/** @defgroup I2C_SR3_Bit_Masks Битовые маски регистра I2C Status Register 3 (SR3)
+ * @{
+ */
+
+/** @brief Шина занята */
+#define I2C_SR3_BUSY ((uint8_t)0x02)
+
+/** @} */
+
+/** @defgroup I2C_ITR_Bit_Masks Битовые маски регистра I2C Interrupt Register (ITR)
+ * @{
+ */
+
+/** @brief Разрешение прерываний по ошибкам */
+#define I2C_ITR_ITERREN ((uint8_t)0x01)
+
+/** @brief Разрешение прерываний по событиям (SB, ADDR, BTF) */
+#define I2C_ITR_ITEVTEN ((uint8_t)0x02)
+
+/** @brief Разрешение прерываний по буферу (TXE, RXNE) */
+#define I2C_ITR_ITBUFEN ((uint8_t)0x04)
+
+/** @} */
+
 /** @defgroup I2C_OARH_Bit_Masks Битовые маски регистра I2C Own Address Register High (OARH)
  * @{
  */
@@ -84,6 +130,118 @@ typedef enum
     I2C_FAST_MODE      /**< Быстрый режим (400 кГц) */
 } I2C_Mode_t;
 
+/**
+ * @enum I2C_Priority_t
+ * @brief Приоритет транзакции в очереди
+ *
+ * Транзакции с более высоким приоритетом запускаются раньше, внутри одного приоритета — в порядке постановки.
+ */
+typedef enum
+{
+    I2C_PRIORITY_HIGH = 0, /**< Запись журнала и данных (EEPROM) */
+    I2C_PRIORITY_LOW = 1,  /**< Обновление дисплея */
+    I2C_PRIORITY_COUNT     /**< Количество уровней приоритета */
+} I2C_Priority_t;
+
+/** @defgroup I2C_Timing Ограничения времени ожидания
+ * @{
+ */
+
+/** @brief Максимальное число опросов флага (~1 байт на 100 кГц с 10-кратным запасом, ~8 тактов на опрос) */
+#ifndef I2C_TIMEOUT_LOOPS
+#define I2C_TIMEOUT_LOOPS ((uint16_t)(F_CPU / 8000UL))
+#endif
+
+/** @brief Число итераций пустого цикла на полупериод SCL при восстановлении шины (~5 мкс, ~5 тактов на итерацию) */
+#ifndef I2C_RECOVERY_DELAY_LOOPS
+#define I2C_RECOVERY_DELAY_LOOPS ((uint8_t)(F_CPU / 1000000UL + 1))
+#endif
+
+/** @brief Время без продвижения фоновой транзакции, после которого она прерывается (@ref I2C_Service) */
+#define I2C_XFER_TIMEOUT_MS 10
+
+/** @brief Количество повторов транзакции в @ref I2C_Transfer после ошибки */
+#define I2C_MAX_RETRIES 2
+
+/** @brief Размер таблицы счетчиков ошибок по устройствам */
+#define I2C_STATS_DEVICES 4
+
+/** @} */
+
+/**
+ * @enum I2C_Status_t
+ * @brief Результат операции на шине I2C
+ */
+typedef enum
+{
+    I2C_OK = 0,          /**< Успешно */
+    I2C_ERR_TIMEOUT = 1, /**< Флаг не установился за отведенное время */
+    I2C_ERR_NACK = 2,    /**< Нет подтверждения от ведомого (SR2.AF) */
+    I2C_ERR_ARLO = 3,    /**< Потеря арбитража (SR2.ARLO) */
+    I2C_ERR_BERR = 4     /**< Ошибка шины: неожиданный START/STOP (SR2.BERR) */
+} I2C_Status_t;
+
+/** @brief Значение поля status транзакции, находящейся в очереди или выполняющейся */
+#define I2C_XFER_PENDING 0xFF
+
+/**
+ * @struct I2C_DeviceStats_t
+ * @brief Счетчики ошибок обмена с одним устройством
+ */
+typedef struct
+{
+    uint8_t address;    /**< Адрес устройства (бит R/W сброшен), 0 — запись свободна */
+    uint8_t last_error; /**< Последняя ошибка @ref I2C_Status_t */
+    uint16_t errors;    /**< Всего ошибок */
+    uint16_t timeouts;  /**< Из них тайм-аутов */
+    uint16_t retries;   /**< Повторов транзакций */
+} I2C_DeviceStats_t;
+
+/** @defgroup I2C_Transaction_Flags Флаги транзакции
+ * @{
+ */
+#define I2C_XFER_RESTART 0x01 /**< @brief Между записью и чтением повторный START вместо STOP/START */
+/** @} */
+
+struct I2C_Transaction;
+
+/**
+ * @brief Функция обратного вызова по завершении транзакции
+ *
+ * Вызывается из обработчика прерывания I2C, а при прерывании зависшей транзакции по тайм-ауту
+ * (@ref I2C_Transfer, @ref I2C_Flush, @ref I2C_Service) — из основного цикла при замаскированных
+ * прерываниях I2C (I2C_ITR = 0). Может ставить в очередь новые транзакции.
+ *
+ * @param transaction Завершенная транзакция, результат — в поле status
+ */
+typedef void (*I2C_Callback_t)(struct I2C_Transaction *transaction);
+
+/**
+ * @struct I2C_Transaction
+ * @brief Описатель транзакции I2C
+ *
+ * Транзакция состоит из фазы записи (заголовок header, затем tx) и, если rx_len > 0,
+ * фазы чтения в буфер rx. Заголовок хранится в самом описателе и предназначен для
+ * служебных байтов: контрольного байта SSD1306, адреса ячейки EEPROM.
+ *
+ * Описатели принадлежат вызывающему коду и не должны изменяться, пока status == @ref I2C_XFER_PENDING.
+ */
+typedef struct I2C_Transaction
+{
+    uint8_t address;                  /**< Адрес ведомого устройства (бит R/W сброшен) */
+    uint8_t header[2];                /**< Заголовок фазы записи */
+    uint8_t header_len;               /**< Длина заголовка (0..2) */
+    const uint8_t *tx;                /**< Данные фазы записи */
+    uint16_t tx_len;                  /**< Количество байтов записи */
+    uint8_t *rx;                      /**< Буфер фазы чтения */
+    uint16_t rx_len;                  /**< Количество байтов чтения */
+    uint8_t flags;                    /**< Флаги @ref I2C_Transaction_Flags */
+    uint8_t priority;                 /**< Приоритет @ref I2C_Priority_t */
+    volatile uint8_t status;          /**< @ref I2C_Status_t или @ref I2C_XFER_PENDING */
+    I2C_Callback_t callback;          /**< Вызывается по завершении (может быть NULL) */
+    struct I2C_Transaction *next;     /**< Используется очередью */
+} I2C_Transaction_t;
+
 /**
  * @brief Инициализация интерфейса I2C
  *
@@ -103,25 +261,38 @@ uint8_t I2C_Init(I2C_Mode_t mode);
 
 /**
  * @brief Генерирует условие START на шине I2C
+ *
+ * Все блокирующие функции ограничены по времени (@ref I2C_TIMEOUT_LOOPS). После первой ошибки
+ * последовательности последующие вызовы сразу возвращают ту же ошибку, итог сообщает @ref I2C_Stop.
+ *
+ * Захватывает шину для блокирующего обмена: функция дожидается выполнения очереди транзакций,
+ * а новые транзакции очереди не запускаются до вызова @ref I2C_Stop.
  */
-void I2C_Start(void);
+I2C_Status_t I2C_Start(void);
 
 /**
  * @brief Генерирует условие STOP на шине I2C
+ *
+ * Освобождает шину и запускает транзакции, поставленные в очередь за время блокирующего обмена.
+ * При ошибке тайм-аута, потери арбитража или ошибке шины выполняет @ref I2C_RecoverBus.
+ *
+ * @return Первая ошибка последовательности с момента @ref I2C_Start или @ref I2C_OK
  */
-void I2C_Stop(void);
+I2C_Status_t I2C_Stop(void);
 
 /**
  * @brief Отправляет адрес ведомого устройства на шину I2C
  * @param address Адрес ведомого устройства
+ * @return Результат операции
  */
-void I2C_WriteAddress(uint8_t address);
+I2C_Status_t I2C_WriteAddress(uint8_t address);
 
 /**
  * @brief Отправляет байт данных на шину I2C
  * @param data Байтовые данные для отправки
+ * @return Результат операции
  */
-void I2C_WriteData(uint8_t data);
+I2C_Status_t I2C_WriteData(uint8_t data);
 
 /**
  * @brief Читает байт данных с шины I2C с подтверждением (ACK)
@@ -135,4 +306,78 @@ uint8_t I2C_ReadData_ACK(void);
  */
 uint8_t I2C_ReadData_NACK(void);
 
+/**
+ * @brief Ставит транзакцию в очередь
+ *
+ * Шиной владеет единственный планировщик: транзакции выполняются обработчиком прерывания I2C
+ * в порядке приоритета, следующая запускается сразу по завершении предыдущей, без простоя шины.
+ * Пока шина захвачена блокирующими функциями (@ref I2C_Start ... @ref I2C_Stop), очередь ожидает.
+ *
+ * @param[in,out] transaction Описатель транзакции. NULL — только запустить обработку очереди.
+ *
+ * @code
+ *  static I2C_Transaction_t t;
+ *  t.address = EEPROM_I2C_ADDRESS;
+ *  t.header[0] = 0x00; t.header[1] = 0x10; t.header_len = 2;
+ *  t.tx = 0; t.tx_len = 0;
+ *  t.rx = buffer; t.rx_len = 4;
+ *  t.flags = I2C_XFER_RESTART;
+ *  t.priority = I2C_PRIORITY_HIGH;
+ *  t.callback = 0;
+ *  I2C_Submit(&t);
+ *  // ... работа основного цикла, затем проверка t.status
+ * @endcode
+ *
+ * @note Требует глобально разрешенных прерываний.
+ */
+void I2C_Submit(I2C_Transaction_t *transaction);
+
+/**
+ * @brief Выполняет транзакцию через очередь и дожидается ее завершения
+ *
+ * Время ожидания ограничено: если обработчик прерывания не продвигается в течение
+ * @ref I2C_TIMEOUT_LOOPS опросов, текущая транзакция прерывается с @ref I2C_ERR_TIMEOUT
+ * и выполняется восстановление шины. После ошибки транзакция повторяется до @ref I2C_MAX_RETRIES раз.
+ *
+ * @param[in,out] transaction Описатель транзакции
+ * @return Результат последней попытки
+ */
+I2C_Status_t I2C_Transfer(I2C_Transaction_t *transaction);
+
+/**
+ * @brief Дожидается выполнения всех транзакций очереди (с тем же ограничением времени, что и @ref I2C_Transfer)
+ */
+void I2C_Flush(void);
+
+/**
+ * @brief Сторожевая проверка фоновых транзакций
+ *
+ * Вызывается из основного цикла. Если текущая транзакция не продвигается дольше
+ * @ref I2C_XFER_TIMEOUT_MS (по TIM4), она завершается с @ref I2C_ERR_TIMEOUT и шина восстанавливается.
+ */
+void I2C_Service(void);
+
+/**
+ * @brief Восстанавливает зависшую шину
+ *
+ * Отключает периферию, подает до 9 тактов на SCL (PB4), пока ведомое устройство не отпустит
+ * SDA (PB5), формирует условие STOP, выполняет программный сброс и повторную инициализацию
+ * в последнем режиме @ref I2C_Init.
+ */
+void I2C_RecoverBus(void);
+
+/**
+ * @brief Возвращает счетчики ошибок устройства
+ *
+ * @param[in] address Адрес устройства
+ * @return Указатель на счетчики или NULL, если обращений к устройству не было
+ */
+const I2C_DeviceStats_t *I2C_GetDeviceStats(uint8_t address);
+
+/**
+ * @brief Проверяет, есть ли невыполненные транзакции
+ * @return 1, если транзакция выполняется или очередь не пуста, иначе 0
+ */
+uint8_t I2C_IsBusy(void);
+
 #endif /* I2C_H */
@@ -6,10 +6,33 @@
 #include "spi.h"
 #include "my_iostm8s103.h"
 
+/* Текущее значение SPI_CR1 без бита SPE: делитель, CPOL/CPHA и MSTR */
+static uint8_t spi_profile;
+
+/* Ожидание (SPI_SR & flag) == state с ограничением по числу опросов; OVR прерывает ожидание */
+static SPI_Status_t SPI_WaitFlag(uint8_t flag, uint8_t state)
+{
+    uint16_t budget = SPI_TIMEOUT_LOOPS;
+    uint8_t sr;
+
+    while (((sr = SPI_SR) & flag) != state)
+    {
+        if (sr & SPI_SR_OVR)
+        {
+            return SPI_ERR_OVR;
+        }
+        if (--budget == 0)
+        {
+            return SPI_ERR_TIMEOUT;
+        }
+    }
+    return (sr & SPI_SR_OVR) ? SPI_ERR_OVR : SPI_OK;
+}
+
 uint8_t SPI_Init(void)
 {
     /* Включение тактирования для периферии SPI */
-    CLK_PCKENR1 |= (1 << 1); /* Регистр включения тактирования периферии, Bit1 отвечает за SPI */
+    CLK_PCKENR1 |= CLK_PCKENR1_SPI; /* Регистр включения тактирования периферии */
 
     /* Настройка GPIO пинов для SPI */
 
@@ -28,24 +51,21 @@ uint8_t SPI_Init(void)
     PC_CR1 |= (1 << 5); /* Устанавливаем режим Push-Pull для PC5 */
     PC_CR2 |= (1 << 5); /* Устанавливаем высокую скорость для PC5 */
 
-    /* Настройка PA3 (CS) как выход Push-Pull */
-    PA_DDR |= (1 << 3); /* Устанавливаем PA3 как выход */
-    PA_CR1 |= (1 << 3); /* Устанавливаем режим Push-Pull для PA3 */
-    PA_CR2 |= (1 << 3); /* Устанавливаем высокую скорость для PA3 */
-
     /* Сброс регистров SPI */
     SPI_CR1 = 0x00;
     SPI_CR2 = 0x00;
 
     /* Конфигурация регистра управления SPI 1 (SPI_CR1) */
     SPI_CR1 |= SPI_CR1_MSTR;       /* Устанавливаем режим мастера */
-    SPI_CR1 |= SPI_BAUDRATE_DIV16; /* Устанавливаем делитель частоты на f_Master/16 */
+    SPI_CR1 |= SPI_BAUDRATE_FOR(SPI_INIT_SCK_HZ); /* Делитель частоты: SCK не выше SPI_INIT_SCK_HZ */
     SPI_CR1 &= ~(SPI_CR1_CPOL);    /* Полярность тактового сигнала: CPOL = 0 */
     SPI_CR1 &= ~(SPI_CR1_CPHA);    /* Фаза тактового сигнала: CPHA = 0 */
 
     /* Конфигурация регистра управления SPI 2 (SPI_CR2) */
     SPI_CR2 |= SPI_CR2_SSM | SPI_CR2_SSI; /* Включаем программное управление подчинённым устройством */
 
+    spi_profile = SPI_CR1;
+
     /* Включение SPI */
     SPI_CR1 |= SPI_CR1_SPE;
 
@@ -60,23 +80,134 @@ uint8_t SPI_Init(void)
     }
 }
 
+void SPI_DeviceInit(const SPI_Device_t *device)
+{
+    volatile uint8_t *port = device->cs_odr;
+
+    port[0] |= device->cs_mask; /* Px_ODR: CS неактивен (высокий уровень) */
+    port[2] |= device->cs_mask; /* Px_DDR: выход */
+    port[3] |= device->cs_mask; /* Px_CR1: Push-Pull */
+    port[4] |= device->cs_mask; /* Px_CR2: высокая скорость */
+}
+
+void SPI_Select(const SPI_Device_t *device)
+{
+    uint8_t profile = SPI_CR1_MSTR | device->cr1;
+
+    if (profile != spi_profile)
+    {
+        /* CPOL, CPHA и делитель можно менять только при выключенном SPI */
+        SPI_WaitFlag(SPI_SR_BSY, 0);
+        SPI_CR1 = profile;
+        SPI_CR1 = profile | SPI_CR1_SPE;
+        spi_profile = profile;
+    }
+
+    *device->cs_odr &= (uint8_t)~device->cs_mask;
+}
+
+void SPI_Deselect(const SPI_Device_t *device)
+{
+    *device->cs_odr |= device->cs_mask;
+}
+
 uint8_t SPI_ReadWriteByte(uint8_t data)
 {
     /* Ожидание, пока буфер передачи не станет пустым */
-    while (!(SPI_SR & SPI_SR_TXE))
-        ;
+    SPI_WaitFlag(SPI_SR_TXE, SPI_SR_TXE);
 
     /* Запись данных в регистр данных SPI */
     SPI_DR = data;
 
     /* Ожидание завершения приёма данных */
-    while (!(SPI_SR & SPI_SR_RXNE))
-        ;
+    SPI_WaitFlag(SPI_SR_RXNE, SPI_SR_RXNE);
 
     /* Чтение и возврат принятых данных */
     return SPI_DR;
 }
 
+/* Обмен буфером; вызывается при запрещенных прерываниях */
+static SPI_Status_t SPI_TransferLocked(const uint8_t *tx, uint8_t *rx, uint16_t length)
+{
+    SPI_Status_t status;
+    uint8_t data;
+
+    /* Сброс данных и флага OVR, оставшихся от предыдущего обмена (чтение DR, затем SR) */
+    data = SPI_DR;
+    data = SPI_SR;
+
+    /* Первый байт загружается сразу: буфер передачи пуст */
+    if ((status = SPI_WaitFlag(SPI_SR_TXE, SPI_SR_TXE)) != SPI_OK)
+    {
+        return status;
+    }
+    SPI_DR = tx ? *tx++ : SPI_DUMMY_BYTE;
+
+    while (--length)
+    {
+        /* Следующий байт в буфер передачи, пока предыдущий в сдвиговом регистре */
+        data = tx ? *tx++ : SPI_DUMMY_BYTE;
+        if ((status = SPI_WaitFlag(SPI_SR_TXE, SPI_SR_TXE)) != SPI_OK)
+        {
+            return status;
+        }
+        SPI_DR = data;
+
+        /* Байт, принятый за предыдущий такт */
+        if ((status = SPI_WaitFlag(SPI_SR_RXNE, SPI_SR_RXNE)) != SPI_OK)
+        {
+            return status;
+        }
+        data = SPI_DR;
+        if (rx)
+        {
+            *rx++ = data;
+        }
+    }
+
+    /* Последний байт */
+    if ((status = SPI_WaitFlag(SPI_SR_RXNE, SPI_SR_RXNE)) != SPI_OK)
+    {
+        return status;
+    }
+    data = SPI_DR;
+    if (rx)
+    {
+        *rx = data;
+    }
+
+    /* Ожидание полного окончания передачи */
+    return SPI_WaitFlag(SPI_SR_BSY, 0);
+}
+
+SPI_Status_t SPI_Transfer(const uint8_t *tx, uint8_t *rx, uint16_t length)
+{
+    SPI_Status_t status;
+    uint8_t cc;
+
+    if (length == 0)
+    {
+        return SPI_OK;
+    }
+
+    /* Обработчик прерывания между TXE и RXNE привел бы к переполнению приёмного буфера */
+    cc = IRQ_SAVE_DISABLE();
+    status = SPI_TransferLocked(tx, rx, length);
+    IRQ_RESTORE(cc);
+
+    return status;
+}
+
+SPI_Status_t SPI_Write(const uint8_t *tx, uint16_t length)
+{
+    return SPI_Transfer(tx, 0, length);
+}
+
+SPI_Status_t SPI_Read(uint8_t *rx, uint16_t length)
+{
+    return SPI_Transfer(0, rx, length);
+}
+
 void SPI_Enable(void)
 {
     SPI_CR1 |= SPI_CR1_SPE;
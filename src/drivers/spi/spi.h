@@ -9,6 +9,7 @@
 #define SPI_H
 
 #include <stdint.h> /* Для типов uint8_t и т.д. */
+#include "clk.h"      /* F_CPU */
 
 /**
  * @defgroup SPI_CR1 Биты регистра управления SPI_CR1
@@ -38,6 +39,8 @@
  */
 #define SPI_SR_RXNE (1 << 0) /**< @brief Флаг: Принятые данные доступны в буфере */
 #define SPI_SR_TXE (1 << 1)  /**< @brief Флаг: Буфер передачи пуст */
+#define SPI_SR_OVR (1 << 6)  /**< @brief Флаг: Переполнение приёмного буфера */
+#define SPI_SR_BSY (1 << 7)  /**< @brief Флаг: Идёт передача */
 /** @} */                    // end of SPI_SR
 
 /**
@@ -55,13 +58,57 @@
 #define SPI_BAUDRATE_DIV256 (7 << 3) /**< @brief Делитель скорости передачи: 256 */
 /** @} */                            // end of SPI_BAUDRATE
 
+/**
+ * @brief Делитель SPI_CR1_BR для частоты SCK не выше hz при текущей @ref F_CPU
+ */
+#define SPI_BAUDRATE_FOR(hz) (CLK_SPI_BR_CODE(hz) << 3)
+
+/** @brief Частота SCK после @ref SPI_Init, Гц */
+#define SPI_INIT_SCK_HZ 1000000UL
+
+/** @brief Байт, передаваемый при чтении без буфера передачи */
+#define SPI_DUMMY_BYTE 0x00
+
+/** @brief Максимальное число опросов флага: ~1 байт на самой низкой частоте SCK (@ref SPI_INIT_SCK_HZ) с 10-кратным запасом */
+#ifndef SPI_TIMEOUT_LOOPS
+#define SPI_TIMEOUT_LOOPS ((uint16_t)CLK_SPI_TIMEOUT_LOOPS(SPI_INIT_SCK_HZ))
+#endif
+
+/**
+ * @enum SPI_Status_t
+ * @brief Результат обмена по шине SPI
+ */
+typedef enum
+{
+    SPI_OK = 0,          /**< Успешно */
+    SPI_ERR_TIMEOUT = 1, /**< Флаг не установился за @ref SPI_TIMEOUT_LOOPS опросов */
+    SPI_ERR_OVR = 2      /**< Переполнение приёмного буфера (SPI_SR.OVR) */
+} SPI_Status_t;
+
+/**
+ * @struct SPI_Device_t
+ * @brief Профиль устройства на шине SPI
+ *
+ * Хранится во FLASH (static const) в драйвере устройства. Порт CS задается адресом регистра
+ * Px_ODR; регистры DDR, CR1 и CR2 того же порта расположены по смещениям +2, +3 и +4.
+ */
+typedef struct
+{
+    uint8_t cr1;               /**< Делитель (@ref SPI_BAUDRATE_FOR) и биты CPOL/CPHA */
+    volatile uint8_t *cs_odr;  /**< Регистр Px_ODR порта линии CS */
+    uint8_t cs_mask;           /**< Маска вывода CS в порту */
+} SPI_Device_t;
+
+/** @brief Адрес регистра Px_ODR для поля @ref SPI_Device_t.cs_odr */
+#define SPI_CS_PORT(odr) ((volatile uint8_t *)&(odr))
+
 /**
  * @brief  Инициализация периферийного модуля SPI
  *
  * Эта функция конфигурирует периферийный модуль SPI микроконтроллера STM8S103F3
  * в режиме мастера с заданными настройками. Rонфигурация:
  * - Режим мастера
- * - Делитель частоты тактового сигнала: f_Master/16
+ * - Частота тактового сигнала: не выше @ref SPI_INIT_SCK_HZ (делитель вычисляется из @ref F_CPU)
  * - Полярность тактового сигнала: CPOL = 0 (активный высокий уровень)
  * - Фаза тактового сигнала: CPHA = 0 (данные считываются по переднему фронту)
  * - Программное управление выбором подчиненного устройства (SS).
@@ -70,7 +117,9 @@
  * - PC6 (MOSI): выход Push-Pull, высокая скорость
  * - PC7 (MISO): вход Floating
  * - PC5 (SCK): выход Push-Pull, высокая скорость
- * - PA3 (CS): выход Push-Pull, высокая скорость
+ *
+ * Линии CS настраиваются драйверами устройств через @ref SPI_DeviceInit, скорость и режим
+ * переключаются в @ref SPI_Select.
  *
  * @return uint8_t Статус инициализации
  * @retval 0  Успешная инициализация SPI.
@@ -97,16 +146,81 @@
  */
 uint8_t SPI_Init(void);
 
+/**
+ * @brief Настройка линии CS устройства
+ *
+ * Переводит вывод CS в режим выхода Push-Pull с высокой скоростью и устанавливает высокий уровень.
+ *
+ * @param[in] device Профиль устройства
+ */
+void SPI_DeviceInit(const SPI_Device_t *device);
+
+/**
+ * @brief Выбор устройства на шине
+ *
+ * Если профиль устройства отличается от текущего, дожидается окончания передачи и
+ * перенастраивает SPI_CR1 (при выключенном SPE). Затем опускает линию CS.
+ *
+ * @param[in] device Профиль устройства
+ */
+void SPI_Select(const SPI_Device_t *device);
+
+/**
+ * @brief Освобождение устройства: поднимает линию CS
+ *
+ * @param[in] device Профиль устройства
+ */
+void SPI_Deselect(const SPI_Device_t *device);
+
 /**
  * @brief Передача и приём одного байта через SPI
  *
  * Передаёт один байт по шине SPI и одновременно принимает байт с шины SPI.
+ * Ожидание флагов ограничено @ref SPI_TIMEOUT_LOOPS опросами.
  *
  * @param data Байт, который нужно передать
  * @return Принятый байт с шины SPI
  */
 uint8_t SPI_ReadWriteByte(uint8_t data);
 
+/**
+ * @brief Конвейерный обмен буфером через SPI
+ *
+ * Следующий байт записывается в SPI_DR сразу после установки TXE, пока предыдущий еще
+ * передается сдвиговым регистром, а принятый байт забирается по RXNE. Байты идут по шине
+ * без пауз. Функция возвращается после снятия флага BSY, поэтому линию CS можно поднимать сразу.
+ *
+ * Принятый байт должен быть прочитан до окончания передачи следующего, поэтому обмен идет при
+ * запрещенных прерываниях (маска восстанавливается по окончании). Если все же произошло
+ * переполнение или флаг не установился за @ref SPI_TIMEOUT_LOOPS опросов, обмен прерывается.
+ *
+ * @param[in]  tx     Данные для передачи или 0 (передается @ref SPI_DUMMY_BYTE)
+ * @param[out] rx     Буфер для принятых данных или 0 (принятые байты отбрасываются)
+ * @param      length Количество байт
+ * @return SPI_Status_t @ref SPI_OK или код ошибки; при ошибке содержимое rx не определено
+ *
+ * @warning Прерывания задерживаются на время всего обмена (8 периодов SCK на байт).
+ */
+SPI_Status_t SPI_Transfer(const uint8_t *tx, uint8_t *rx, uint16_t length);
+
+/**
+ * @brief Передача буфера через SPI без сохранения принятых данных
+ *
+ * @param[in] tx     Данные для передачи
+ * @param     length Количество байт
+ * @return SPI_Status_t Результат @ref SPI_Transfer
+ */
+SPI_Status_t SPI_Write(const uint8_t *tx, uint16_t length);
+
+/**
+ * @brief Приём буфера через SPI с передачей @ref SPI_DUMMY_BYTE
+ *
+ * @param[out] rx     Буфер для принятых данных
+ * @param      length Количество байт
+ * @return SPI_Status_t Результат @ref SPI_Transfer
+ */
+SPI_Status_t SPI_Read(uint8_t *rx, uint16_t length);
+
 /**
  * @brief Включение периферийного модуля SPI
  *
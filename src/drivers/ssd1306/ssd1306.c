@@ -8,15 +8,59 @@
 #include "font5x7.h"
 #include "my_str.h"
 
-void SSD1306_WriteCommand(uint8_t command)
+/* Последовательность инициализации SSD1306, хранится во FLASH */
+static const uint8_t ssd1306_init_commands[] = {
+    0xAE,       // Выключить дисплей
+    0xD5, 0x80, // Установка тактовой частоты: частота по умолчанию
+    0xA8, 0x3F, // Установка мультиплексного коэффициента: 1/64 duty
+    0xD3, 0x00, // Установка смещения дисплея: нет смещения
+    0x40,       // Установка стартовой линии
+    0x8D, 0x14, // Настройка зарядового насоса: включить
+    0x20, 0x00, // Режим адресации памяти: горизонтальный
+    0xA1,       // Разворот сегментов
+    0xC8,       // Направление сканирования COM
+    0xDA, 0x12, // Конфигурация COM пинов
+    0x81, 0xCF, // Контрастность
+    0xD9, 0xF1, // Установка периода предварительной зарядки
+    0xDB, 0x40, // Установка уровня VCOMH
+    0xA4,       // Восстановить отображение из RAM
+    0xA6,       // Нормальный режим отображения
+    0x2E,       // Отключить прокрутку
+    0xAF        // Включить дисплей
+};
+
+/* Транзакции асинхронной записи окна: команды окна и данные, ставятся в очередь друг за другом */
+static uint8_t ssd1306_async_window[6];
+static I2C_Transaction_t ssd1306_window_xfer;
+static I2C_Transaction_t ssd1306_data_xfer;
+
+static void SSD1306_BuildWindow(uint8_t *commands, uint8_t column_start, uint8_t column_end, uint8_t page_start, uint8_t page_end)
+{
+    commands[0] = 0x21;                // Диапазон адресов столбцов
+    commands[1] = column_start & 0x7F; // Начальный столбец
+    commands[2] = column_end & 0x7F;   // Конечный столбец
+    commands[3] = 0x22;                // Диапазон адресов страниц
+    commands[4] = page_start & 0x07;   // Начальная страница
+    commands[5] = page_end & 0x07;     // Конечная страница
+}
+
+void SSD1306_WriteCommandList(const uint8_t *commands, uint8_t length)
 {
     I2C_Start();
     I2C_WriteAddress(SSD1306_I2C_ADDRESS); // Адрес I2C + бит записи
-    I2C_WriteData(SSD1306_COMMAND);        // Контрольный байт: Co = 0, D/C# = 0
-    I2C_WriteData(command);                // Байт команды
+    I2C_WriteData(SSD1306_COMMAND);        // Контрольный байт: Co = 0, D/C# = 0 (далее только команды)
+    while (length--)
+    {
+        I2C_WriteData(*commands++); // Байты команд и их параметров
+    }
     I2C_Stop();
 }
 
+void SSD1306_WriteCommand(uint8_t command)
+{
+    SSD1306_WriteCommandList(&command, 1);
+}
+
 void SSD1306_WriteData(uint8_t data)
 {
     I2C_Start();
@@ -26,111 +70,168 @@ void SSD1306_WriteData(uint8_t data)
     I2C_Stop();
 }
 
-void SSD1306_Init(void)
+void SSD1306_DataBegin(void)
 {
-    // Последовательность инициализации для SSD1306
-    SSD1306_WriteCommand(0xAE); // Выключить дисплей
-
-    SSD1306_WriteCommand(0xD5); // Установка тактовой частоты
-    SSD1306_WriteCommand(0x80); // Частота по умолчанию
-
-    SSD1306_WriteCommand(0xA8); // Установка мультиплексного коэффициента
-    SSD1306_WriteCommand(0x3F); // 1/64 duty
-
-    SSD1306_WriteCommand(0xD3); // Установка смещения дисплея
-    SSD1306_WriteCommand(0x00); // Нет смещения
+    I2C_Start();
+    I2C_WriteAddress(SSD1306_I2C_ADDRESS); // Адрес I2C + бит записи
+    I2C_WriteData(SSD1306_DATA);           // Контрольный байт: Co = 0, D/C# = 1 (далее только данные)
+}
 
-    SSD1306_WriteCommand(0x40); // Установка стартовой линии
+void SSD1306_DataPush(const uint8_t *data, uint16_t length)
+{
+    while (length--)
+    {
+        I2C_WriteData(*data++);
+    }
+}
 
-    SSD1306_WriteCommand(0x8D); // Настройка зарядового насоса
-    SSD1306_WriteCommand(0x14); // Включить зарядовой насос
+void SSD1306_DataFill(uint8_t value, uint16_t count)
+{
+    while (count--)
+    {
+        I2C_WriteData(value);
+    }
+}
 
-    SSD1306_WriteCommand(0x20); // Режим адресации памяти
-    SSD1306_WriteCommand(0x00); // Горизонтальный режим адресации
+void SSD1306_DataPushChar(char c)
+{
+    // Проверка на допустимый диапазон символов
+    if (c < 32 || c > 126)
+    {
+        c = ' '; // Заменяем недопустимые символы пробелом
+    }
 
-    SSD1306_WriteCommand(0xA1); // Разворот сегментов
-    SSD1306_WriteCommand(0xC8); // Направление сканирования COM
+    SSD1306_DataPush(font5x7[c - 32], 5);
+    I2C_WriteData(0x00); // Пробел между символами
+}
 
-    SSD1306_WriteCommand(0xDA); // Конфигурация COM пинов
-    SSD1306_WriteCommand(0x12);
+void SSD1306_DataEnd(void)
+{
+    I2C_Stop();
+}
 
-    SSD1306_WriteCommand(0x81); // Контрастность
-    SSD1306_WriteCommand(0xCF);
+void SSD1306_RenderChar(char c, uint8_t *columns)
+{
+    const unsigned char *bitmap;
+    uint8_t i;
 
-    SSD1306_WriteCommand(0xD9); // Установка периода предварительной зарядки
-    SSD1306_WriteCommand(0xF1);
+    if (c < 32 || c > 126)
+    {
+        c = ' ';
+    }
 
-    SSD1306_WriteCommand(0xDB); // Установка уровня VCOMH
-    SSD1306_WriteCommand(0x40);
+    bitmap = font5x7[c - 32];
+    for (i = 0; i < 5; i++)
+    {
+        columns[i] = bitmap[i];
+    }
+    columns[5] = 0x00; // Пробел между символами
+}
 
-    SSD1306_WriteCommand(0xA4); // Восстановить отображение из RAM
-    SSD1306_WriteCommand(0xA6); // Нормальный режим отображения
+uint8_t SSD1306_WriteWindowAsync(uint8_t column_start, uint8_t column_end, uint8_t page_start, uint8_t page_end,
+                                 const uint8_t *data, uint16_t length, I2C_Callback_t callback)
+{
+    if (ssd1306_window_xfer.status == I2C_XFER_PENDING || ssd1306_data_xfer.status == I2C_XFER_PENDING)
+    {
+        return 1;
+    }
 
-    SSD1306_WriteCommand(0x2E); // Отключить прокрутку
+    SSD1306_BuildWindow(ssd1306_async_window, column_start, column_end, page_start, page_end);
+
+    ssd1306_window_xfer.address = SSD1306_I2C_ADDRESS;
+    ssd1306_window_xfer.header[0] = SSD1306_COMMAND;
+    ssd1306_window_xfer.header_len = 1;
+    ssd1306_window_xfer.tx = ssd1306_async_window;
+    ssd1306_window_xfer.tx_len = sizeof(ssd1306_async_window);
+    ssd1306_window_xfer.rx_len = 0;
+    ssd1306_window_xfer.flags = 0;
+    ssd1306_window_xfer.priority = I2C_PRIORITY_LOW;
+    ssd1306_window_xfer.callback = 0;
+
+    ssd1306_data_xfer = ssd1306_window_xfer;
+    ssd1306_data_xfer.header[0] = SSD1306_DATA;
+    ssd1306_data_xfer.tx = data;
+    ssd1306_data_xfer.tx_len = length;
+    ssd1306_data_xfer.callback = callback;
+
+    /* Обе транзакции в одной очереди: данные идут сразу за командами окна */
+    I2C_Submit(&ssd1306_window_xfer);
+    I2C_Submit(&ssd1306_data_xfer);
+    return 0;
+}
 
-    SSD1306_WriteCommand(0xAF); // Включить дисплей
+void SSD1306_Init(void)
+{
+    // Вся последовательность инициализации передается одной транзакцией
+    SSD1306_WriteCommandList(ssd1306_init_commands, sizeof(ssd1306_init_commands));
 
     SSD1306_Clear(); // Очистить дисплей
 }
 
 void SSD1306_Clear(void)
 {
-    uint8_t page, column;
+    // Окно на весь экран: 1024 байта передаются одной транзакцией
+    SSD1306_SetCursor(0, 0);
+    SSD1306_DataBegin();
+    SSD1306_DataFill(0x00, SSD1306_WIDTH * SSD1306_PAGES);
+    SSD1306_DataEnd();
+}
 
-    for (page = 0; page < 8; page++)
-    {
-        SSD1306_WriteCommand(0xB0 | page); // Установка адреса страницы
-        SSD1306_WriteCommand(0x00);        // Установка младшего адреса столбца
-        SSD1306_WriteCommand(0x10);        // Установка старшего адреса столбца
+void SSD1306_SetWindow(uint8_t column_start, uint8_t column_end, uint8_t page_start, uint8_t page_end)
+{
+    uint8_t commands[6];
 
-        for (column = 0; column < 128; column++)
-        {
-            SSD1306_WriteData(0x00); // Очистить данные
-        }
-    }
+    SSD1306_BuildWindow(commands, column_start, column_end, page_start, page_end);
+    SSD1306_WriteCommandList(commands, sizeof(commands));
 }
 
 void SSD1306_SetCursor(uint8_t column, uint8_t page)
 {
-    SSD1306_WriteCommand(0xB0 | (page & 0x07));          // Установка адреса страницы
-    SSD1306_WriteCommand(0x00 | (column & 0x0F));        // Младший адрес столбца
-    SSD1306_WriteCommand(0x10 | ((column >> 4) & 0x0F)); // Старший адрес столбца
+    // В горизонтальном режиме адресации курсор задается окном от (column, page) до правого нижнего угла
+    SSD1306_SetWindow(column, SSD1306_WIDTH - 1, page, SSD1306_PAGES - 1);
 }
 
 void SSD1306_WriteChar(char c)
 {
-    unsigned char i;
-    const unsigned char *bitmap;
+    SSD1306_DataBegin();
+    SSD1306_DataPushChar(c);
+    SSD1306_DataEnd();
+}
 
-    // Проверка на допустимый диапазон символов
-    if (c < 32 || c > 126)
+void SSD1306_WriteString(const char *str)
+{
+    if (*str == '\0')
     {
-        c = ' '; // Заменяем недопустимые символы пробелом
+        return;
     }
 
-    bitmap = font5x7[c - 32];
-
-    for (i = 0; i < 5; i++)
+    // Вся строка передается одной транзакцией
+    SSD1306_DataBegin();
+    while (*str)
     {
-        SSD1306_WriteData(bitmap[i]);
+        SSD1306_DataPushChar(*str++);
     }
+    SSD1306_DataEnd();
+}
 
-    SSD1306_WriteData(0x00); // Пробел между символами
+/* Глиф символа сразу в открытую транзакцию данных */
+static void SSD1306_EmitGlyph(void *context, char c)
+{
+    (void)context;
+    SSD1306_DataPushChar(c);
 }
 
-void SSD1306_WriteString(const char *str)
+void SSD1306_WriteFixed(int32_t value, uint8_t frac_digits, uint8_t width)
 {
-    while (*str)
-    {
-        SSD1306_WriteChar(*str++);
-    }
+    // Число передается одной транзакцией, цифры рисуются по мере получения
+    SSD1306_DataBegin();
+    fixed_emit(value, frac_digits, width, ' ', SSD1306_EmitGlyph, 0);
+    SSD1306_DataEnd();
 }
 
 void SSD1306_WriteInt(int32_t num)
 {
-    char buffer[12];             // Буфер для строки
-    int_to_str(num, buffer);     // Преобразуем число в строку
-    SSD1306_WriteString(buffer); // Выводим строку на дисплей
+    SSD1306_WriteFixed(num, 0, 0);
 }
 
 void SSD1306_DisplayOn(void)
@@ -143,19 +244,95 @@ void SSD1306_DisplayOff(void)
     SSD1306_WriteCommand(0xAE);
 }
 
+void SSD1306_SetContrast(uint8_t contrast)
+{
+    uint8_t commands[2];
+
+    commands[0] = 0x81; // Контрастность
+    commands[1] = contrast;
+
+    SSD1306_WriteCommandList(commands, sizeof(commands));
+}
+
+void SSD1306_StartScroll(SSD1306_ScrollDir_t direction, uint8_t page_start, uint8_t page_end, uint8_t interval)
+{
+    uint8_t commands[9];
+
+    commands[0] = 0x2E;                     // Прокрутку необходимо отключить перед изменением параметров
+    commands[1] = (uint8_t)direction;       // Горизонтальная прокрутка вправо (0x26) или влево (0x27)
+    commands[2] = 0x00;                     // Фиктивный байт
+    commands[3] = page_start & 0x07;        // Начальная страница
+    commands[4] = interval & 0x07;          // Интервал между шагами в кадрах
+    commands[5] = page_end & 0x07;          // Конечная страница
+    commands[6] = 0x00;                     // Фиктивный байт
+    commands[7] = 0xFF;                     // Фиктивный байт
+    commands[8] = 0x2F;                     // Включить прокрутку
+
+    SSD1306_WriteCommandList(commands, sizeof(commands));
+}
+
+void SSD1306_StopScroll(void)
+{
+    SSD1306_WriteCommand(0x2E);
+}
+
 void SSD1306_DrawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t width, uint8_t height)
 {
-    uint8_t i, j;
-    uint8_t byte_height = (height + 7) / 8; /**< Высота в байтах (количество страниц по вертикали). */
-
-    for (j = 0; j < byte_height; j++)
-    { /**< Проход по страницам. */
-        for (i = 0; i < width; i++)
-        { /**< Проход по пикселям по ширине. */
-            /** Установка курсора в нужное место. */
-            SSD1306_SetCursor(x + i, y / 8 + j); /**< y / 8 — определение страницы. */
-            /** Отправка данных из битмапа на дисплей. */
-            SSD1306_WriteData(bitmap[j * width + i]);
+    uint8_t src_pages = (height + 7) / 8; /**< Высота битмапа в страницах. */
+    int16_t page_top;                     /**< Страница дисплея, в которую попадает строка y (может быть < 0). */
+    uint8_t shift;                        /**< Смещение битмапа внутри страницы в пикселях (0..7). */
+    int16_t col_start, col_end, page_start, page_end;
+    int16_t col, page, k;
+    uint8_t i, data;
+
+    if (width == 0 || height == 0)
+    {
+        return;
+    }
+
+    /** Деление с округлением вниз, корректное и для отрицательных y. */
+    page_top = (y >= 0) ? (y >> 3) : -((7 - y) >> 3);
+    shift = (uint8_t)(y - page_top * 8);
+
+    /** Отсечение по границам экрана. */
+    col_start = (x < 0) ? 0 : x;
+    col_end = x + width - 1;
+    if (col_end > SSD1306_WIDTH - 1)
+    {
+        col_end = SSD1306_WIDTH - 1;
+    }
+    page_start = (page_top < 0) ? 0 : page_top;
+    page_end = page_top + (shift + height + 7) / 8 - 1;
+    if (page_end > SSD1306_PAGES - 1)
+    {
+        page_end = SSD1306_PAGES - 1;
+    }
+    if (col_start > col_end || page_start > page_end)
+    {
+        return;
+    }
+
+    /** Окно задается один раз, затем весь блит передается одной транзакцией. */
+    SSD1306_SetWindow((uint8_t)col_start, (uint8_t)col_end, (uint8_t)page_start, (uint8_t)page_end);
+    SSD1306_DataBegin();
+    for (page = page_start; page <= page_end; page++)
+    {
+        k = page - page_top; /**< Индекс страницы битмапа, нижняя часть которой попадает в эту страницу. */
+        for (col = col_start; col <= col_end; col++)
+        {
+            i = (uint8_t)(col - x);
+            data = 0;
+            if (k < src_pages)
+            {
+                data = (uint8_t)(bitmap[k * width + i] << shift);
+            }
+            if (shift != 0 && k > 0)
+            {
+                /** Верхняя часть страницы: старшие биты предыдущей страницы битмапа. */
+                data |= (uint8_t)(bitmap[(k - 1) * width + i] >> (8 - shift));
+            }
+            I2C_WriteData(data);
         }
     }
+    SSD1306_DataEnd();
 }
@@ -10,6 +10,7 @@
 #define SSD1306_H
 
 #include <stdint.h>
+#include "i2c.h"
 
 /**
  * @def SSD1306_I2C_ADDRESS
@@ -35,10 +36,133 @@
  */
 #define SSD1306_DATA 0x40
 
+/** @brief Ширина дисплея в пикселях (столбцах) */
+#define SSD1306_WIDTH 128
+
+/** @brief Количество страниц дисплея (высота 64 пикселя / 8) */
+#define SSD1306_PAGES 8
+
+/**
+ * @enum SSD1306_ScrollDir_t
+ * @brief Направление аппаратной горизонтальной прокрутки
+ */
+typedef enum
+{
+    SSD1306_SCROLL_RIGHT = 0x26, /**< Прокрутка вправо */
+    SSD1306_SCROLL_LEFT = 0x27   /**< Прокрутка влево */
+} SSD1306_ScrollDir_t;
+
+/**
+ * @brief Отправляет список команд дисплею одной транзакцией I2C
+ *
+ * После контрольного байта @ref SSD1306_COMMAND (Co = 0) все последующие байты транзакции
+ * интерпретируются дисплеем как команды и их параметры. Список может храниться во FLASH.
+ *
+ * @param[in] commands Указатель на массив команд
+ * @param[in] length   Количество байтов в массиве
+ */
+void SSD1306_WriteCommandList(const uint8_t *commands, uint8_t length);
+
+/**
+ * @brief Отправляет одну команду дисплею отдельной транзакцией I2C
+ *
+ * @param[in] command Байт команды
+ *
+ * @see SSD1306_WriteCommandList
+ */
+void SSD1306_WriteCommand(uint8_t command);
+
+/**
+ * @brief Отправляет один байт графических данных отдельной транзакцией I2C
+ *
+ * @param[in] data Байт данных (8 вертикальных пикселей текущего столбца)
+ *
+ * @note Для передачи более одного байта используйте потоковый интерфейс @ref SSD1306_DataBegin.
+ */
+void SSD1306_WriteData(uint8_t data);
+
+/**
+ * @brief Открывает потоковую передачу графических данных
+ *
+ * Генерирует START, передает адрес дисплея и контрольный байт @ref SSD1306_DATA.
+ * Все байты, переданные до вызова @ref SSD1306_DataEnd, записываются в GDDRAM
+ * подряд в рамках одной транзакции I2C.
+ *
+ * @code
+ *  SSD1306_SetCursor(0, 0);
+ *  SSD1306_DataBegin();
+ *  SSD1306_DataFill(0x00, 128); // Очистить страницу 0
+ *  SSD1306_DataEnd();
+ * @endcode
+ *
+ * @warning Пока поток открыт, шина I2C занята: вызов других функций драйвера,
+ *          отправляющих команды, недопустим.
+ */
+void SSD1306_DataBegin(void);
+
+/**
+ * @brief Передает массив байтов в открытый поток данных
+ *
+ * @param[in] data   Указатель на данные
+ * @param[in] length Количество байтов
+ */
+void SSD1306_DataPush(const uint8_t *data, uint16_t length);
+
+/**
+ * @brief Передает в открытый поток данных count одинаковых байтов
+ *
+ * @param[in] value Значение байта
+ * @param[in] count Количество повторений
+ */
+void SSD1306_DataFill(uint8_t value, uint16_t count);
+
+/**
+ * @brief Передает в открытый поток данных столбцы одного символа (5 столбцов глифа + 1 пустой)
+ *
+ * @param[in] c Символ; недопустимые символы заменяются пробелом
+ */
+void SSD1306_DataPushChar(char c);
+
+/**
+ * @brief Завершает потоковую передачу данных (условие STOP)
+ */
+void SSD1306_DataEnd(void);
+
+/**
+ * @brief Формирует столбцы одного символа в буфере
+ *
+ * @param[in]  c       Символ; недопустимые символы заменяются пробелом
+ * @param[out] columns Буфер не менее 6 байт: 5 столбцов глифа и пустой столбец
+ */
+void SSD1306_RenderChar(char c, uint8_t *columns);
+
+/**
+ * @brief Асинхронно записывает данные в окно дисплея
+ *
+ * Ставит в очередь I2C две транзакции с низким приоритетом: установку окна (@ref SSD1306_SetWindow)
+ * и передачу данных. Функция возвращается сразу, по завершении передачи данных из прерывания I2C
+ * вызывается callback.
+ *
+ * @param[in] column_start Первый столбец окна (0..127)
+ * @param[in] column_end   Последний столбец окна (0..127)
+ * @param[in] page_start   Первая страница окна (0..7)
+ * @param[in] page_end     Последняя страница окна (0..7)
+ * @param[in] data         Данные для записи; буфер должен оставаться неизменным до завершения
+ * @param[in] length       Количество байтов данных
+ * @param[in] callback     Функция, вызываемая по завершении (обязательна)
+ *
+ * @return 0 — передача поставлена в очередь, 1 — предыдущая асинхронная запись еще не завершена
+ *
+ * @see I2C_Submit
+ */
+uint8_t SSD1306_WriteWindowAsync(uint8_t column_start, uint8_t column_end, uint8_t page_start, uint8_t page_end,
+                                 const uint8_t *data, uint16_t length, I2C_Callback_t callback);
+
 /**
  * @brief Инициализирует дисплей SSD1306
  * @details Настраивает основные параметры дисплея, включая разрешение, режим работы и интерфейс связи.
- *          Необходима для подготовки дисплея к приему данных.
+ *          Необходима для подготовки дисплея к приему данных. Вся последовательность команд хранится
+ *          во FLASH и передается одной транзакцией.
  * @warning Функция не проверяет корректность инициализации I2C. Убедитесь, что шина I2C настроена правильно перед вызовом.
  */
 void SSD1306_Init(void);
@@ -48,14 +172,28 @@ void SSD1306_Init(void);
  *
  * Заполняет весь дисплей черным цветом (гасит все пиксели), подготавливая его к рисованию новой информации.
  *
- * @note После очистки курсор остается на предыдущей позиции. Для изменения позиции используйте @ref SSD1306_SetCursor.
+ * @note После очистки курсор указывает на позицию (0, 0). Для изменения позиции используйте @ref SSD1306_SetCursor.
  */
 void SSD1306_Clear(void);
 
+/**
+ * @brief Задает окно вывода в горизонтальном режиме адресации
+ *
+ * Отправляет команды 0x21 (диапазон столбцов) и 0x22 (диапазон страниц). Последующие данные
+ * заполняют окно слева направо, переходя на следующую страницу окна в конце каждой строки.
+ *
+ * @param[in] column_start Первый столбец окна (0..127)
+ * @param[in] column_end   Последний столбец окна (0..127)
+ * @param[in] page_start   Первая страница окна (0..7)
+ * @param[in] page_end     Последняя страница окна (0..7)
+ */
+void SSD1306_SetWindow(uint8_t column_start, uint8_t column_end, uint8_t page_start, uint8_t page_end);
+
 /**
  * @brief Устанавливает позицию курсора
  *
  * Задает текущую позицию курсора для последующей отрисовки символов или графических объектов.
+ * Реализована как окно от (column, page) до правого нижнего угла экрана.
  *
  * @param[in] column Колонка (X-координата) от 0 до 127
  * @param[in] page   Страница (Y-координата) от 0 до 7 (для дисплея 128x64)
@@ -88,16 +226,28 @@ void SSD1306_WriteChar(char c);
  */
 void SSD1306_WriteString(const char *str);
 
+/**
+ * @brief Выводит число с фиксированной точкой на дисплей
+ *
+ * Цифры формируются @ref fixed_emit и сразу передаются глифами в одну транзакцию данных,
+ * начиная с текущей позиции курсора, без промежуточной строки.
+ *
+ * @param[in] value Значение, умноженное на 10^frac_digits (например, -123 при frac_digits = 2 — "-1.23").
+ * @param[in] frac_digits Количество цифр после точки, от 0 до 9.
+ * @param[in] width Ширина поля: короткое значение выравнивается вправо пробелами, что стирает
+ *                  предыдущее, более длинное значение. 0 — без выравнивания.
+ * @see fixed_emit
+ */
+void SSD1306_WriteFixed(int32_t value, uint8_t frac_digits, uint8_t width);
+
 /**
  * @brief Выводит целое число на дисплей
  *
- * Преобразует заданное целое число в строку и выводит ее на дисплей, начиная с текущей позиции курсора.
- * Использует функцию @ref int_to_str из `my_str.h` для преобразования числа в строку.
+ * Выводит число, начиная с текущей позиции курсора, через @ref SSD1306_WriteFixed без дробной части.
  *
  * @param[in] num Целое число типа int32_t для отображения. Диапазон значений зависит от размера типа `int32_t`.
  *
- * @note Функция использует статический буфер для хранения строки.
- * @see SSD1306_WriteString, int_to_str
+ * @see SSD1306_WriteFixed
  */
 void SSD1306_WriteInt(int32_t num);
 
@@ -105,14 +255,20 @@ void SSD1306_WriteInt(int32_t num);
  * @brief Отображает битовое изображение на дисплее
  *
  * Рисует изображение на дисплее по заданным координатам. Изображение должно быть закодировано в массиве bitmap.
+ * Окно вывода (@ref SSD1306_SetWindow) задается один раз, после чего изображение передается одной транзакцией.
+ * Координата y может быть произвольной: при y, не кратном 8, каждая страница дисплея собирается
+ * сдвигом из двух соседних страниц битмапа. Части изображения за границами экрана отсекаются.
  *
- * @param[in] x       Начальная X-координата (колонка) от 0 до ширины дисплея
- * @param[in] y       Начальная Y-координата (страница) от 0 до количества страниц дисплея
+ * @param[in] x       Начальная X-координата (колонка) в пикселях, может выходить за границы экрана
+ * @param[in] y       Начальная Y-координата (строка) в пикселях, может выходить за границы экрана
  * @param[in] bitmap  Указатель на массив байтов, содержащий битовое изображение
  * @param[in] width   Ширина изображения в пикселях
  * @param[in] height  Высота изображения в пикселях
  *
- * @note Формат изображения: вертикальная ориентация, 1 бит на пиксель.
+ * @note Формат изображения: вертикальная ориентация, 1 бит на пиксель, страницы по width байт.
+ * @note Содержимое дисплея не считывается: пиксели страниц, частично занятых изображением,
+ *       но лежащие вне его, гасятся.
+ * @note После вызова окно вывода ограничено изображением. Перед выводом текста установите курсор.
  */
 void SSD1306_DrawBitmap(int16_t x, int16_t y, const uint8_t *bitmap, uint8_t width, uint8_t height);
 
@@ -134,4 +290,32 @@ void SSD1306_DisplayOn(void);
  */
 void SSD1306_DisplayOff(void);
 
+/**
+ * @brief Устанавливает контрастность дисплея
+ *
+ * @param[in] contrast Значение контрастности от 0x00 до 0xFF
+ */
+void SSD1306_SetContrast(uint8_t contrast);
+
+/**
+ * @brief Запускает аппаратную горизонтальную прокрутку
+ *
+ * Настройка и запуск прокрутки выполняются одной транзакцией.
+ *
+ * @param[in] direction  Направление прокрутки
+ * @param[in] page_start Первая прокручиваемая страница (0..7)
+ * @param[in] page_end   Последняя прокручиваемая страница (0..7), не меньше page_start
+ * @param[in] interval   Код интервала между шагами прокрутки (0..7, см. документацию SSD1306)
+ *
+ * @warning Во время прокрутки запись в GDDRAM недопустима. Остановите прокрутку вызовом @ref SSD1306_StopScroll.
+ */
+void SSD1306_StartScroll(SSD1306_ScrollDir_t direction, uint8_t page_start, uint8_t page_end, uint8_t interval);
+
+/**
+ * @brief Останавливает аппаратную прокрутку
+ *
+ * @note После остановки содержимое GDDRAM необходимо перерисовать.
+ */
+void SSD1306_StopScroll(void);
+
 #endif // SSD1306_H
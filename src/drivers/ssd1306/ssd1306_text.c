@@ -0,0 +1,269 @@
+/**
+ * @file ssd1306_text.c
+ * @brief Реализация текстового слоя с кэшем символьных ячеек для дисплея SSD1306
+ */
+
+#include "ssd1306_text.h"
+#include "ssd1306.h"
+#include "i2c.h"
+#include "my_str.h"
+#include "my_iostm8s103.h"
+
+/* Символы, которые должны отображаться в ячейках */
+static char text_cells[SSD1306_TEXT_ROWS][SSD1306_TEXT_COLUMNS];
+
+/* Битовые маски ячеек, не совпадающих с содержимым дисплея */
+static uint8_t text_dirty[SSD1306_TEXT_ROWS][(SSD1306_TEXT_COLUMNS + 7) / 8];
+
+#define TEXT_IS_DIRTY(row, col) (text_dirty[row][(col) >> 3] & (uint8_t)(1 << ((col) & 7)))
+#define TEXT_SET_DIRTY(row, col) (text_dirty[row][(col) >> 3] |= (uint8_t)(1 << ((col) & 7)))
+#define TEXT_CLR_DIRTY(row, col) (text_dirty[row][(col) >> 3] &= (uint8_t) ~(1 << ((col) & 7)))
+
+/* Состояние асинхронного обновления: столбцы текущей группы ячеек и обрабатываемая строка */
+static uint8_t text_run[SSD1306_TEXT_RUN_MAX * SSD1306_TEXT_CELL_WIDTH];
+static volatile uint8_t text_async_busy = 0;
+static uint8_t text_async_row;
+
+static void SSD1306_TextMarkAll(uint8_t mask)
+{
+    uint8_t row, i;
+
+    for (row = 0; row < SSD1306_TEXT_ROWS; row++)
+    {
+        for (i = 0; i < sizeof(text_dirty[0]); i++)
+        {
+            text_dirty[row][i] = mask;
+        }
+    }
+}
+
+/* Ждет завершения асинхронного обновления, обслуживая шину I2C (зависшая транзакция прерывается по тайм-ауту) */
+static void SSD1306_TextWaitIdle(void)
+{
+    while (text_async_busy)
+    {
+        I2C_Flush();
+    }
+}
+
+void SSD1306_TextClear(void)
+{
+    uint8_t row, col;
+
+    SSD1306_TextWaitIdle();
+
+    SSD1306_Clear();
+
+    for (row = 0; row < SSD1306_TEXT_ROWS; row++)
+    {
+        for (col = 0; col < SSD1306_TEXT_COLUMNS; col++)
+        {
+            text_cells[row][col] = ' ';
+        }
+    }
+    SSD1306_TextMarkAll(0x00);
+}
+
+void SSD1306_TextInvalidate(void)
+{
+    SSD1306_TextMarkAll(0xFF);
+}
+
+/* Записывает символ в ячейку и помечает ее, если символ изменился */
+static void SSD1306_TextPut(uint8_t row, uint8_t column, char c)
+{
+    unsigned char cc;
+
+    if (text_cells[row][column] != c)
+    {
+        text_cells[row][column] = c;
+        cc = IRQ_SAVE_DISABLE(); // Маски изменяются и обработчиком прерывания I2C при асинхронном обновлении
+        TEXT_SET_DIRTY(row, column);
+        IRQ_RESTORE(cc);
+    }
+}
+
+void SSD1306_TextWrite(uint8_t column, uint8_t row, const char *str, uint8_t width)
+{
+    if (row >= SSD1306_TEXT_ROWS)
+    {
+        return;
+    }
+
+    while (column < SSD1306_TEXT_COLUMNS && (*str || width))
+    {
+        SSD1306_TextPut(row, column, *str ? *str++ : ' ');
+
+        if (width)
+        {
+            width--;
+        }
+        column++;
+    }
+}
+
+/* Позиция вывода @ref SSD1306_TextWriteFixed */
+typedef struct
+{
+    uint8_t row;
+    uint8_t column;
+} text_cursor_t;
+
+static void SSD1306_TextEmit(void *context, char c)
+{
+    text_cursor_t *cursor = (text_cursor_t *)context;
+
+    if (cursor->column < SSD1306_TEXT_COLUMNS)
+    {
+        SSD1306_TextPut(cursor->row, cursor->column++, c);
+    }
+}
+
+void SSD1306_TextWriteFixed(uint8_t column, uint8_t row, int32_t value, uint8_t frac_digits, uint8_t width)
+{
+    text_cursor_t cursor;
+
+    if (row >= SSD1306_TEXT_ROWS)
+    {
+        return;
+    }
+
+    cursor.row = row;
+    cursor.column = column;
+
+    if (fixed_length(value, frac_digits) > width)
+    {
+        // Значение не помещается в поле: заполнение звездочками вместо обрезанных цифр
+        while (width--)
+        {
+            SSD1306_TextEmit(&cursor, '*');
+        }
+        return;
+    }
+
+    fixed_emit(value, frac_digits, width, ' ', SSD1306_TextEmit, &cursor);
+}
+
+/* Ищет в строке группу изменившихся ячеек длиной не более max_cells.
+ * Возвращает первый столбец группы (или SSD1306_TEXT_COLUMNS, если изменений нет), последний — в *end. */
+static uint8_t SSD1306_TextFindRun(uint8_t row, uint8_t max_cells, uint8_t *end)
+{
+    uint8_t start, next, gap;
+
+    for (start = 0; start < SSD1306_TEXT_COLUMNS; start++)
+    {
+        if (TEXT_IS_DIRTY(row, start))
+        {
+            break;
+        }
+    }
+    if (start == SSD1306_TEXT_COLUMNS)
+    {
+        return start;
+    }
+
+    /* Расширяем группу, пока разрывы между изменениями не длиннее SSD1306_TEXT_MERGE_GAP */
+    *end = start;
+    gap = 0;
+    for (next = start + 1; next < SSD1306_TEXT_COLUMNS && next - start < max_cells; next++)
+    {
+        if (TEXT_IS_DIRTY(row, next))
+        {
+            *end = next;
+            gap = 0;
+        }
+        else if (++gap > SSD1306_TEXT_MERGE_GAP)
+        {
+            break;
+        }
+    }
+    return start;
+}
+
+void SSD1306_TextFlush(void)
+{
+    uint8_t row, col, end;
+
+    SSD1306_TextWaitIdle();
+
+    for (row = 0; row < SSD1306_TEXT_ROWS; row++)
+    {
+        while ((col = SSD1306_TextFindRun(row, SSD1306_TEXT_COLUMNS, &end)) < SSD1306_TEXT_COLUMNS)
+        {
+            /* Одна установка курсора и одна транзакция на всю группу */
+            SSD1306_SetCursor(col * SSD1306_TEXT_CELL_WIDTH, row);
+            SSD1306_DataBegin();
+            for (; col <= end; col++)
+            {
+                SSD1306_DataPushChar(text_cells[row][col]);
+                TEXT_CLR_DIRTY(row, col);
+            }
+            SSD1306_DataEnd();
+        }
+    }
+}
+
+/* Продолжение асинхронного обновления, вызывается из прерывания I2C по завершении предыдущей группы */
+static void SSD1306_TextAsyncNext(I2C_Transaction_t *transaction)
+{
+    uint8_t start, end, col;
+    uint8_t *columns;
+
+    if (transaction && transaction->status != I2C_OK)
+    {
+        /* Содержимое дисплея неизвестно — при следующем обновлении перерисовать все */
+        SSD1306_TextMarkAll(0xFF);
+        text_async_busy = 0;
+        return;
+    }
+
+    for (; text_async_row < SSD1306_TEXT_ROWS; text_async_row++)
+    {
+        start = SSD1306_TextFindRun(text_async_row, SSD1306_TEXT_RUN_MAX, &end);
+        if (start == SSD1306_TEXT_COLUMNS)
+        {
+            continue;
+        }
+
+        columns = text_run;
+        for (col = start; col <= end; col++)
+        {
+            SSD1306_RenderChar(text_cells[text_async_row][col], columns);
+            columns += SSD1306_TEXT_CELL_WIDTH;
+            TEXT_CLR_DIRTY(text_async_row, col);
+        }
+
+        if (SSD1306_WriteWindowAsync(start * SSD1306_TEXT_CELL_WIDTH, (end + 1) * SSD1306_TEXT_CELL_WIDTH - 1,
+                                     text_async_row, text_async_row,
+                                     text_run, (uint16_t)(columns - text_run), SSD1306_TextAsyncNext))
+        {
+            /* Транзакция не поставлена в очередь — группа остается непрорисованной до следующего обновления */
+            for (col = start; col <= end; col++)
+            {
+                TEXT_SET_DIRTY(text_async_row, col);
+            }
+            text_async_busy = 0;
+        }
+        return;
+    }
+
+    text_async_busy = 0;
+}
+
+uint8_t SSD1306_TextFlushAsync(void)
+{
+    if (text_async_busy)
+    {
+        return 1;
+    }
+
+    text_async_busy = 1;
+    text_async_row = 0;
+    SSD1306_TextAsyncNext(0);
+    return 0;
+}
+
+uint8_t SSD1306_TextIsBusy(void)
+{
+    return text_async_busy;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file ssd1306_text.h
+ * @brief Текстовый слой с кэшем символьных ячеек для дисплея SSD1306
+ *
+ * Экран 128x64 разбивается на сетку 21x8 ячеек размером 6x8 пикселей (глиф 5x7 + межсимвольный интервал).
+ * Слой хранит символ, нарисованный в каждой ячейке, и при обновлении передает на дисплей только
+ * столбцы изменившихся ячеек. Соседние изменения объединяются в одну оконную запись.
+ */
+
+#ifndef SSD1306_TEXT_H
+#define SSD1306_TEXT_H
+
+#include <stdint.h>
+
+/** @brief Количество текстовых столбцов (128 / 6) */
+#define SSD1306_TEXT_COLUMNS 21
+
+/** @brief Количество текстовых строк (по одной на страницу) */
+#define SSD1306_TEXT_ROWS 8
+
+/** @brief Ширина ячейки в пикселях */
+#define SSD1306_TEXT_CELL_WIDTH 6
+
+/**
+ * @brief Максимальное количество неизменившихся ячеек между изменениями, при котором они
+ *        объединяются в одну транзакцию.
+ *
+ * Повторная передача одной ячейки (6 байт) дешевле, чем новая установка курсора и новая транзакция.
+ */
+#define SSD1306_TEXT_MERGE_GAP 1
+
+/**
+ * @brief Максимальное количество ячеек в одной транзакции асинхронного обновления
+ *
+ * Определяет размер буфера столбцов глифов (SSD1306_TEXT_RUN_MAX * 6 байт ОЗУ).
+ */
+#define SSD1306_TEXT_RUN_MAX 8
+
+/**
+ * @brief Очищает дисплей и кэш ячеек
+ *
+ * После вызова все ячейки считаются содержащими пробел и синхронизированными с дисплеем.
+ */
+void SSD1306_TextClear(void);
+
+/**
+ * @brief Помечает все ячейки как требующие перерисовки
+ *
+ * Используется после вывода на дисплей в обход текстового слоя (например, @ref SSD1306_DrawBitmap).
+ */
+void SSD1306_TextInvalidate(void);
+
+/**
+ * @brief Записывает строку в кэш ячеек
+ *
+ * Символы, отличающиеся от уже нарисованных, помечаются для передачи при следующем
+ * вызове @ref SSD1306_TextFlush. Строка обрезается по правому краю экрана.
+ *
+ * @param[in] column Текстовый столбец от 0 до @ref SSD1306_TEXT_COLUMNS - 1
+ * @param[in] row    Текстовая строка от 0 до @ref SSD1306_TEXT_ROWS - 1
+ * @param[in] str    Строка, заканчивающаяся нулевым байтом
+ * @param[in] width  Ширина поля: если строка короче, остаток дополняется пробелами,
+ *                   что стирает хвост предыдущего, более длинного значения. 0 — без дополнения.
+ */
+void SSD1306_TextWrite(uint8_t column, uint8_t row, const char *str, uint8_t width);
+
+/**
+ * @brief Записывает число с фиксированной точкой в кэш ячеек
+ *
+ * Цифры формируются @ref fixed_emit и записываются прямо в ячейки, без промежуточной строки.
+ * Значение выравнивается вправо в поле фиксированной ширины, поэтому хвост предыдущего значения
+ * всегда стирается. Значение, не помещающееся в поле, выводится звездочками.
+ *
+ * @param[in] column      Текстовый столбец от 0 до @ref SSD1306_TEXT_COLUMNS - 1
+ * @param[in] row         Текстовая строка от 0 до @ref SSD1306_TEXT_ROWS - 1
+ * @param[in] value       Значение, умноженное на 10^frac_digits
+ * @param[in] frac_digits Количество цифр после точки, от 0 до 9
+ * @param[in] width       Ширина поля в ячейках
+ */
+void SSD1306_TextWriteFixed(uint8_t column, uint8_t row, int32_t value, uint8_t frac_digits, uint8_t width);
+
+/**
+ * @brief Передает на дисплей все изменившиеся ячейки
+ *
+ * Для каждой группы соседних изменившихся ячеек выполняется одна установка курсора
+ * и одна транзакция данных. Если выполняется фоновое обновление, функция дожидается его завершения.
+ */
+void SSD1306_TextFlush(void);
+
+/**
+ * @brief Запускает фоновую передачу изменившихся ячеек
+ *
+ * Группы не длиннее @ref SSD1306_TEXT_RUN_MAX ячеек ставятся в очередь I2C с низким приоритетом
+ * по одной, следующая — из обработчика прерывания по завершении предыдущей. Основной цикл в это
+ * время продолжает работу. Ячейки, измененные во время передачи, будут переданы при следующем обновлении.
+ *
+ * @return 0 — обновление запущено, 1 — предыдущее обновление еще не завершено
+ *
+ * @see SSD1306_TextIsBusy
+ */
+uint8_t SSD1306_TextFlushAsync(void);
+
+/**
+ * @brief Проверяет, выполняется ли фоновое обновление
+ * @return 1, если обновление выполняется, иначе 0
+ */
+uint8_t SSD1306_TextIsBusy(void);
+
+#endif /* SSD1306_TEXT_H */
@@ -1,7 +1,11 @@
 #include "tim4.h"
+#include "clk.h"
 #include "my_iostm8s103.h"
 #include <stdint.h>
 
+/* Флаг обновления (переполнения) в TIM4_SR */
+#define TIM4_SR_UIF 0x01
+
 volatile uint32_t time_ms = 0;
 
 void TIM4_Init(void);
@@ -22,11 +26,14 @@ void TIM4_Init(void)
     /* Остановка таймера */
     TIM4_CR1 = 0x00;
 
-    /* Настройка предделителя на 8 */
-    TIM4_PSCR = 0x03;
+    /* Включение тактирования TIM4 */
+    CLK_PCKENR1 |= CLK_PCKENR1_TIM4;
+
+    /* Предделитель 2^CLK_TIM4_PSCR, вычисляется из F_CPU */
+    TIM4_PSCR = CLK_TIM4_PSCR;
 
-    /* Настройка значения тактов таймера для получения прерывания каждую миллисекунду */
-    TIM4_ARR = 250;
+    /* Счет от 0 до ARR включительно: переполнение ровно каждую миллисекунду */
+    TIM4_ARR = (uint8_t)CLK_TIM4_ARR;
 
     /* Сброс счетчика */
     TIM4_CNTR = 0x00;
@@ -43,7 +50,54 @@ void TIM4_Init(void)
 
 uint32_t TIM4_GetMillis(void)
 {
-    return time_ms;
+    uint32_t ms;
+
+    /* 32-битное значение читается по байтам: повтор, если обработчик изменил его во время чтения */
+    do
+    {
+        ms = time_ms;
+    } while (ms != time_ms);
+
+    return ms;
+}
+
+uint32_t TIM4_GetMicros(void)
+{
+    uint32_t ms;
+    uint8_t ticks;
+
+    do
+    {
+        ms = time_ms;
+        ticks = TIM4_CNTR;
+
+        /* Переполнение, которое обработчик еще не учел (прерывания запрещены или выполняется
+         * другой обработчик): счетчик уже начал новую миллисекунду */
+        if (TIM4_SR & TIM4_SR_UIF)
+        {
+            ticks = TIM4_CNTR;
+            ms++;
+        }
+        /* Результат согласован, если ms равно time_ms или опережает его на учтенное здесь
+         * переполнение; иначе обработчик сработал между чтениями — повтор */
+    } while ((uint32_t)(ms - time_ms) > 1);
+
+    return ms * 1000UL + (uint16_t)ticks * CLK_TIM4_US_PER_TICK;
+}
+
+uint32_t TIM4_ElapsedMillis(uint32_t start_ms)
+{
+    return TIM4_ELAPSED(start_ms, TIM4_GetMillis());
+}
+
+uint32_t TIM4_ElapsedMicros(uint32_t start_us)
+{
+    return TIM4_ELAPSED(start_us, TIM4_GetMicros());
+}
+
+uint8_t TIM4_DeadlineReached(uint32_t deadline_ms)
+{
+    return TIM4_REACHED(TIM4_GetMillis(), deadline_ms);
 }
 
 uint32_t TIM4_GetSeconds(void)
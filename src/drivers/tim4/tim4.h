@@ -25,10 +25,62 @@ extern "C"
 
     /**
      * @brief Получение количества миллисекунд с момента запуска
+     *
+     * Счетчик читается повторно, пока два чтения не совпадут, поэтому значение не бывает
+     * "разорванным" обработчиком прерывания. Можно вызывать из любого контекста.
+     *
      * @return uint32_t Количество миллисекунд
      */
     uint32_t TIM4_GetMillis(void);
 
+    /**
+     * @brief Отметка времени в микросекундах
+     *
+     * Складывает счетчик миллисекунд с текущим значением TIM4_CNTR (шаг @ref CLK_TIM4_US_PER_TICK мкс).
+     * Если переполнение уже произошло, но еще не обработано (флаг UIF), миллисекунда учитывается здесь;
+     * если обработчик сработал между чтениями, чтение повторяется. Можно вызывать из любого контекста,
+     * в том числе из обработчиков прерываний. Переполняется примерно через 71 минуту — разности
+     * отметок следует вычислять через @ref TIM4_ELAPSED.
+     *
+     * @return uint32_t Время в микросекундах
+     */
+    uint32_t TIM4_GetMicros(void);
+
+    /**
+     * @brief Время, прошедшее между двумя отметками, с учетом переполнения
+     *
+     * Беззнаковое вычитание по модулю 2^32 верно, пока интервал короче периода переполнения.
+     */
+#define TIM4_ELAPSED(start, now) ((uint32_t)((uint32_t)(now) - (uint32_t)(start)))
+
+    /**
+     * @brief Проверка наступления момента deadline с учетом переполнения
+     *
+     * Верна, пока now и deadline отличаются меньше чем на половину периода переполнения.
+     */
+#define TIM4_REACHED(now, deadline) ((int32_t)((uint32_t)(now) - (uint32_t)(deadline)) >= 0)
+
+    /**
+     * @brief Миллисекунды, прошедшие с отметки start_ms (@ref TIM4_GetMillis)
+     * @param[in] start_ms Начальная отметка
+     * @return uint32_t Прошедшее время в миллисекундах
+     */
+    uint32_t TIM4_ElapsedMillis(uint32_t start_ms);
+
+    /**
+     * @brief Микросекунды, прошедшие с отметки start_us (@ref TIM4_GetMicros)
+     * @param[in] start_us Начальная отметка
+     * @return uint32_t Прошедшее время в микросекундах
+     */
+    uint32_t TIM4_ElapsedMicros(uint32_t start_us);
+
+    /**
+     * @brief Проверка истечения срока
+     * @param[in] deadline_ms Момент в миллисекундах (@ref TIM4_GetMillis)
+     * @return 1, если момент наступил, иначе 0
+     */
+    uint8_t TIM4_DeadlineReached(uint32_t deadline_ms);
+
     /**
      * @brief Получение количества секунд с момента запуска
      * @return uint32_t Количество секунд
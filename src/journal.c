@@ -0,0 +1,187 @@
+/**
+ * @file journal.c
+ * @brief Реализация журнала событий в EEPROM
+ */
+
+#include "journal.h"
+#include "adxl345.h"
+#include "eeprom.h"
+#include "tim4.h"
+
+static uint16_t journal_head;      /* Индекс следующей записи в кольце */
+static uint16_t journal_seq;       /* Порядковый номер следующей записи */
+static uint16_t journal_records;   /* Количество записей */
+
+static I2C_Transaction_t journal_xfer;
+static uint8_t journal_buffer[JOURNAL_RECORD_SIZE];
+static uint8_t journal_staged;     /* В буфере запись, ожидающая записи в EEPROM */
+static uint8_t journal_writing;    /* Транзакция записи поставлена в очередь */
+static uint8_t journal_retries;
+static uint32_t journal_done_ms;   /* Завершение последней транзакции: от него отсчитывается цикл записи */
+
+static uint16_t journal_next_seq(uint16_t seq)
+{
+    return (seq + 1 == JOURNAL_SEQ_BLANK) ? 0 : seq + 1;
+}
+
+static uint16_t journal_address(uint16_t index)
+{
+    return EEPROM_ADDR_JOURNAL + index * JOURNAL_RECORD_SIZE;
+}
+
+static void journal_pack(uint8_t *buffer, const journal_record_t *record)
+{
+    buffer[0] = (uint8_t)(record->seq >> 8);
+    buffer[1] = (uint8_t)record->seq;
+    buffer[2] = record->type;
+    buffer[3] = record->axes;
+    buffer[4] = (uint8_t)(record->time_ms >> 24);
+    buffer[5] = (uint8_t)(record->time_ms >> 16);
+    buffer[6] = (uint8_t)(record->time_ms >> 8);
+    buffer[7] = (uint8_t)record->time_ms;
+}
+
+static void journal_unpack(journal_record_t *record, const uint8_t *buffer)
+{
+    record->seq = ((uint16_t)buffer[0] << 8) | buffer[1];
+    record->type = buffer[2];
+    record->axes = buffer[3];
+    record->time_ms = ((uint32_t)buffer[4] << 24) | ((uint32_t)buffer[5] << 16) |
+                      ((uint16_t)buffer[6] << 8) | buffer[7];
+}
+
+static uint8_t journal_read_seq(uint16_t index, uint16_t *seq)
+{
+    uint8_t buffer[2];
+
+    if (EEPROM_Read(journal_address(index), buffer, sizeof(buffer)) != 0)
+    {
+        return 1;
+    }
+    *seq = ((uint16_t)buffer[0] << 8) | buffer[1];
+    return 0;
+}
+
+uint8_t journal_init(void)
+{
+    uint16_t index;
+    uint16_t prev, seq;
+
+    journal_head = 0;
+    journal_seq = 0;
+    journal_records = 0;
+    journal_staged = 0;
+    journal_writing = 0;
+
+    if (journal_read_seq(0, &prev) != 0)
+    {
+        return 1;
+    }
+    if (prev == JOURNAL_SEQ_BLANK)
+    {
+        return 0; /* Журнал пуст */
+    }
+
+    /* Конец журнала — первая запись, номер которой не продолжает предыдущий */
+    for (index = 1; index < JOURNAL_CAPACITY; index++)
+    {
+        if (journal_read_seq(index, &seq) != 0)
+        {
+            return 1;
+        }
+        if (seq != journal_next_seq(prev))
+        {
+            break;
+        }
+        prev = seq;
+    }
+
+    journal_head = index % JOURNAL_CAPACITY;
+    journal_seq = journal_next_seq(prev);
+
+    /* Стертая запись после конца — кольцо еще не заполнялось целиком */
+    journal_records = (index < JOURNAL_CAPACITY && seq == JOURNAL_SEQ_BLANK) ? index : JOURNAL_CAPACITY;
+
+    return 0;
+}
+
+void journal_service(void)
+{
+    ADXL345_Event_t event;
+    journal_record_t record;
+
+    if (journal_writing)
+    {
+        if (journal_xfer.status == I2C_XFER_PENDING)
+        {
+            return;
+        }
+        journal_writing = 0;
+        journal_done_ms = TIM4_GetMillis();
+
+        if (journal_xfer.status == I2C_OK || ++journal_retries > JOURNAL_MAX_RETRIES)
+        {
+            /* Запись завершена (или событие отброшено после повторов) */
+            if (journal_xfer.status == I2C_OK)
+            {
+                journal_head = (journal_head + 1) % JOURNAL_CAPACITY;
+                journal_seq = journal_next_seq(journal_seq);
+                if (journal_records < JOURNAL_CAPACITY)
+                {
+                    journal_records++;
+                }
+            }
+            journal_staged = 0;
+        }
+    }
+
+    if (!journal_staged)
+    {
+        if (!ADXL345_ReadEvent(&event))
+        {
+            return;
+        }
+        record.seq = journal_seq;
+        record.type = event.type;
+        record.axes = event.axes;
+        record.time_ms = event.time_ms;
+        journal_pack(journal_buffer, &record);
+        journal_staged = 1;
+        journal_retries = 0;
+    }
+
+    /* Пока идет внутренний цикл записи предыдущей страницы, EEPROM не отвечает */
+    if (TIM4_ElapsedMillis(journal_done_ms) <= EEPROM_WRITE_TIME_MS)
+    {
+        return;
+    }
+
+    if (EEPROM_WriteAsync(&journal_xfer, journal_address(journal_head), journal_buffer, JOURNAL_RECORD_SIZE, 0) == 0)
+    {
+        journal_writing = 1;
+    }
+}
+
+uint16_t journal_count(void)
+{
+    return journal_records;
+}
+
+uint8_t journal_read(uint16_t back, journal_record_t *record)
+{
+    uint8_t buffer[JOURNAL_RECORD_SIZE];
+    uint16_t index;
+
+    if (back >= journal_records)
+    {
+        return 1;
+    }
+
+    index = (journal_head + JOURNAL_CAPACITY - 1 - back) % JOURNAL_CAPACITY;
+    if (EEPROM_Read(journal_address(index), buffer, sizeof(buffer)) != 0)
+    {
+        return 1;
+    }
+    journal_unpack(record, buffer);
+    return 0;
+}
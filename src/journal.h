@@ -0,0 +1,81 @@
+/**
+ * @file journal.h
+ * @brief Журнал событий акселерометра в EEPROM
+ *
+ * События встроенных детекторов ADXL345 (удар, двойной удар, свободное падение) записываются
+ * в кольцевую область EEPROM начиная с @ref EEPROM_ADDR_JOURNAL. Запись занимает 8 байт,
+ * страница EEPROM вмещает ровно 16 записей, поэтому запись никогда не пересекает страницу.
+ * Порядковый номер записи позволяет найти конец журнала после перезапуска без отдельного
+ * указателя в EEPROM.
+ *
+ * Запись выполняется в фоне через очередь I2C: @ref journal_service только ставит транзакцию
+ * и возвращается, не дожидаясь цикла записи EEPROM.
+ */
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <stdint.h>
+
+/** @brief Размер записи в EEPROM, байт */
+#define JOURNAL_RECORD_SIZE 8
+
+/** @brief Количество записей в кольце (1 КиБ EEPROM) */
+#ifndef JOURNAL_CAPACITY
+#define JOURNAL_CAPACITY 128
+#endif
+
+/** @brief Порядковый номер стертой записи (0xFFFF), никогда не выдается */
+#define JOURNAL_SEQ_BLANK 0xFFFF
+
+/** @brief Количество повторов записи, после которого событие отбрасывается */
+#define JOURNAL_MAX_RETRIES 3
+
+/**
+ * @struct journal_record_t
+ * @brief Запись журнала
+ *
+ * В EEPROM: seq (2 байта), type, axes, time_ms (4 байта), многобайтовые поля — старшим байтом вперед.
+ */
+typedef struct
+{
+    uint16_t seq;     /**< Порядковый номер */
+    uint8_t type;     /**< Тип события (ADXL345_INT_SINGLE_TAP, ADXL345_INT_DOUBLE_TAP, ADXL345_INT_FREE_FALL) */
+    uint8_t axes;     /**< Оси-источники удара (ADXL345_TAP_X/Y/Z) */
+    uint32_t time_ms; /**< Время события с момента запуска, мс */
+} journal_record_t;
+
+/**
+ * @brief Поиск конца журнала
+ *
+ * Читает порядковые номера записей и находит место, где последовательность прерывается.
+ *
+ * @retval 0 Успешно
+ * @retval 1 Ошибка чтения EEPROM (журнал начнется с начала области)
+ */
+uint8_t journal_init(void);
+
+/**
+ * @brief Перенос событий из очереди драйвера в EEPROM
+ *
+ * Вызывается из основного цикла. За один вызов ставит в очередь I2C не более одной записи
+ * и выдерживает время цикла записи EEPROM между записями.
+ */
+void journal_service(void);
+
+/**
+ * @brief Количество записей в журнале (не более @ref JOURNAL_CAPACITY)
+ */
+uint16_t journal_count(void);
+
+/**
+ * @brief Чтение записи журнала
+ *
+ * @param back Номер записи от конца: 0 — самая новая
+ * @param[out] record Запись
+ * @retval 0 Успешно
+ * @retval 1 Записи нет или ошибка чтения
+ */
+uint8_t journal_read(uint16_t back, journal_record_t *record);
+
+#endif /* JOURNAL_H */
@@ -1,12 +1,19 @@
+#include "clk.h"
 #include "delay.h"
 #include "i2c.h"
 #include "ssd1306.h"
+#include "ssd1306_text.h"
 #include "smile_bitmap.h"
 #include "tim4.h"
 #include "my_iostm8s103.h"
 #include "spi.h"
 #include "adxl345.h"
 #include "eeprom.h"
+#include "calib.h"
+#include "journal.h"
+#include "my_decim.h"
+#include "my_math.h"
+#include "sched.h"
 
 #include "my_str.h"
 
@@ -24,7 +31,7 @@ uint8_t EEPROM_SelfTest(void)
     uint8_t i;
 
     /* Записываем тестовые данные */
-    if (EEPROM_Write(0x0000, test_data, sizeof(test_data)) != 0)
+    if (EEPROM_Write(EEPROM_ADDR_SELFTEST, test_data, sizeof(test_data)) != 0)
     {
         return 1; /* Ошибка записи */
     }
@@ -41,7 +48,7 @@ uint8_t EEPROM_SelfTest(void)
     SSD1306_WriteInt(test_data[2]);
 
     /* Читаем записанные данные */
-    if (EEPROM_Read(0x0000, read_data, sizeof(read_data)) != 0)
+    if (EEPROM_Read(EEPROM_ADDR_SELFTEST, read_data, sizeof(read_data)) != 0)
     {
         return 1; /* Ошибка чтения */
     }
@@ -70,12 +77,40 @@ uint8_t EEPROM_SelfTest(void)
 
 #define LOG_DELAY 5000
 
+/* Частота датчика и децимация: 400 Гц / 4 = 100 Гц на выходе CIC-фильтра */
+#define SENSOR_RATE ADXL345_RATE_400
+#define SENSOR_DECIM_LOG2 2
+
+/* Обнаружение покоя: порог активности 0,25g, покой — ниже 0,125g в течение 5 с */
+static const ADXL345_MotionConfig_t motion_config = {
+    4,  /* act_threshold: 4 * 62,5 мг */
+    2,  /* inact_threshold: 2 * 62,5 мг */
+    5,  /* inact_time: 5 с */
+    1}; /* auto_sleep: датчик в покое опрашивает себя с частотой 8 Гц */
+
+/* Детекторы событий: удар 3g короче 10 мс, двойной — второй удар через 100..400 мс,
+   свободное падение — ниже 0,44g дольше 100 мс (рекомендации документации ADXL345) */
+static const ADXL345_EventConfig_t event_config = {
+    48,              /* tap_threshold: 48 * 62,5 мг */
+    16,              /* tap_duration: 16 * 625 мкс */
+    80,              /* tap_latency: 80 * 1,25 мс */
+    240,             /* tap_window: 240 * 1,25 мс */
+    ADXL345_TAP_XYZ, /* tap_axes */
+    7,               /* ff_threshold: 7 * 62,5 мг */
+    20};             /* ff_time: 20 * 5 мс */
+
 /**
  * @brief Инициализация всех периферийных устройств с выводом отладочной информации на OLED-дисплей.
  * @return 0 при успешной инициализации, 1 при ошибке
  */
 uint8_t init(void)
 {
+    uint8_t adxl_status;
+    calib_t calib;
+
+    // Тактирование настраивается первым: от F_CPU зависят параметры всей периферии
+    CLK_Init();
+
     // Иницилизация I2С
     if (I2C_Init(I2C_FAST_MODE) == 1)
         return 1; // Ошибка инициализации I2C
@@ -158,7 +193,8 @@ uint8_t init(void)
     // Инициализация ADXL345
     SSD1306_SetCursor(0, 0);
     SSD1306_WriteString("> Init ADXL345... ");
-    if (ADXL345_Init() == 1) // Успешная инициализация ADXL345
+    adxl_status = ADXL345_Init();
+    if (adxl_status == 0) // Успешная инициализация ADXL345
     {
         SSD1306_WriteString("OK");
         SSD1306_SetCursor(0, 1);
@@ -185,74 +221,229 @@ uint8_t init(void)
     delay(LOG_DELAY);
     SSD1306_Clear();
 
+    // Калибровка ADXL345: восстановление из EEPROM, при первом запуске — измерение и сохранение
+    if (adxl_status == 0)
+    {
+        SSD1306_SetCursor(0, 0);
+        SSD1306_WriteString("> Calib ADXL345... ");
+        if (calib_restore(&calib) == 0)
+        {
+            SSD1306_WriteString("OK");
+        }
+        else
+        {
+            SSD1306_SetCursor(0, 1);
+            SSD1306_WriteString("> Keep level, Z up");
+            if (calib_run(&calib) == 0 && calib_save(&calib) == 0)
+            {
+                SSD1306_SetCursor(0, 2);
+                SSD1306_WriteString("> Saved");
+            }
+            else
+            {
+                SSD1306_SetCursor(0, 2);
+                SSD1306_WriteString("> Calib ERROR");
+            }
+            delay(LOG_DELAY / 5);
+        }
+        SSD1306_Clear();
+
+        // Обнаружение неподвижности: при покое обновление замедляется, ядро спит
+        ADXL345_Motion_Start(&motion_config);
+
+        // Удары и свободное падение записываются в журнал EEPROM
+        journal_init();
+        ADXL345_Events_Start(&event_config);
+
+        // Непрерывный поток выборок через FIFO
+        ADXL345_SetDataRate(SENSOR_RATE);
+        ADXL345_FIFO_Start(ADXL345_FIFO_WATERMARK);
+    }
+
     return 0;
 }
 
+/* Положение полей на экране в текстовых ячейках (см. ssd1306_text.h) */
+#define FIELD_TIME_COLUMN 13  /**< Столбец поля системного времени */
+#define FIELD_VALUE_COLUMN 7  /**< Столбец числовых значений */
+#define FIELD_VALUE_WIDTH 6   /**< Ширина поля числового значения */
+#define FIELD_UNIT_COLUMN 14  /**< Столбец единиц измерения */
+
 /**
  * @brief Отрисовывает заголовки полей на OLED-дисплее.
  *
  * Функция очищает дисплей и выводит заголовки для отображения системного времени,
- * ускорений по осям X, Y, Z и углов крена и тангажа.
+ * ускорений по осям X, Y, Z и углов крена и тангажа, а также единицы измерения.
  */
 void print_titles(void)
 {
-    SSD1306_Clear();
-    SSD1306_SetCursor(0, 0);
-    SSD1306_WriteString("System time: ");
-    SSD1306_SetCursor(0, 2);
-    SSD1306_WriteString("a_X: ");
-    SSD1306_SetCursor(0, 3);
-    SSD1306_WriteString("a_Y: ");
-    SSD1306_SetCursor(0, 4);
-    SSD1306_WriteString("a_Z: ");
-    SSD1306_SetCursor(0, 5);
-    SSD1306_WriteString("Roll: ");
-    SSD1306_SetCursor(0, 6);
-    SSD1306_WriteString("Pitch: ");
+    SSD1306_TextClear();
+    SSD1306_TextWrite(0, 0, "System time: ", 0);
+    SSD1306_TextWrite(0, 2, "a_X: ", 0);
+    SSD1306_TextWrite(FIELD_UNIT_COLUMN, 2, "g", 0);
+    SSD1306_TextWrite(0, 3, "a_Y: ", 0);
+    SSD1306_TextWrite(FIELD_UNIT_COLUMN, 3, "g", 0);
+    SSD1306_TextWrite(0, 4, "a_Z: ", 0);
+    SSD1306_TextWrite(FIELD_UNIT_COLUMN, 4, "g", 0);
+    SSD1306_TextWrite(0, 5, "Roll: ", 0);
+    SSD1306_TextWrite(FIELD_UNIT_COLUMN, 5, "deg", 0);
+    SSD1306_TextWrite(0, 6, "Pitch: ", 0);
+    SSD1306_TextWrite(FIELD_UNIT_COLUMN, 6, "deg", 0);
+    SSD1306_TextFlush();
 }
 
 /**
- * @brief Выводит на OLED-дисплей значения системного времени, ускорений по осям X, Y, Z, углов крена и тангажа.
+ * @brief Выводит на OLED-дисплей системное время.
+ *
+ * Строка записывается в кэш текстового слоя; передачу изменившихся символов на дисплей
+ * выполняет стадия вывода (@ref stage_render).
  *
  * @param time_str Строка, содержащая системное время в формате "ЧЧ:ММ:СС".
- * @param ax_str Строка, содержащая значение ускорения по оси X.
- * @param ay_str Строка, содержащая значение ускорения по оси Y.
- * @param az_str Строка, содержащая значение ускорения по оси Z.
- * @param roll_str Строка, содержащая значение угла крена.
- * @param pitch_str Строка, содержащая значение угла тангажа.
  */
-void display_data(const char *time_str, const char *ax_str, const char *ay_str, const char *az_str, const char *roll_str, const char *pitch_str)
+void display_time(const char *time_str)
+{
+    SSD1306_TextWrite(FIELD_TIME_COLUMN, 0, time_str, 0);
+}
+
+/**
+ * @brief Выводит на OLED-дисплей значения ускорений по осям X, Y, Z, углов крена и тангажа.
+ *
+ * Числа записываются в кэш текстового слоя напрямую через @ref SSD1306_TextWriteFixed, без
+ * промежуточных строк; передачу изменившихся символов на дисплей выполняет стадия вывода (@ref stage_render).
+ *
+ * @param accel_cg Ускорения по осям X, Y, Z в сотых долях g.
+ * @param roll_dd Угол крена в десятых долях градуса.
+ * @param pitch_dd Угол тангажа в десятых долях градуса.
+ */
+void display_values(const int16_t *accel_cg, int16_t roll_dd, int16_t pitch_dd)
+{
+    SSD1306_TextWriteFixed(FIELD_VALUE_COLUMN, 2, accel_cg[0], 2, FIELD_VALUE_WIDTH);
+    SSD1306_TextWriteFixed(FIELD_VALUE_COLUMN, 3, accel_cg[1], 2, FIELD_VALUE_WIDTH);
+    SSD1306_TextWriteFixed(FIELD_VALUE_COLUMN, 4, accel_cg[2], 2, FIELD_VALUE_WIDTH);
+    SSD1306_TextWriteFixed(FIELD_VALUE_COLUMN, 5, roll_dd, 1, FIELD_VALUE_WIDTH);
+    SSD1306_TextWriteFixed(FIELD_VALUE_COLUMN, 6, pitch_dd, 1, FIELD_VALUE_WIDTH);
+}
+
+/*
+ * Задачи планировщика: получение -> фильтр -> углы -> значения -> вывод, плюс часы и фоновые службы.
+ *
+ * Фазы стадий конвейера разнесены на 1 мс, поэтому в пределах одного кадра они выполняются
+ * по порядку и задержка от выборки до пикселей фиксирована. Пока датчик в покое,
+ * все задачи переходят на период 1 с.
+ */
+
+#define FILTER_SHIFT 2   /**< Сглаживание: y += (x - y) / 2^FILTER_SHIFT */
+#define DECIMATED_SIZE (ADXL345_RING_SIZE >> SENSOR_DECIM_LOG2) /**< Выход CIC для всего кольцевого буфера драйвера */
+#define COUNTS_PER_G_LOG2 (8 + DECIM_FRAC_BITS) /**< log2 отсчетов выхода дециматора на 1g */
+
+static decim_t decim;                                  /* CIC-дециматор */
+/* Выход дециматора: кольцо, которое заполняет stage_acquire и опустошает stage_filter.
+   Пропуск запуска фильтра не теряет данных: выборки ждут в кольце или в буфере драйвера */
+static ADXL345_Sample_t decimated[DECIMATED_SIZE];
+static uint8_t decimated_head; /* Пишет только stage_acquire */
+static uint8_t decimated_tail; /* Пишет только stage_filter */
+static int32_t filtered[3];                            /* Сглаженное ускорение, отсчеты << FILTER_SHIFT */
+static int16_t roll_cdeg, pitch_cdeg;                  /* Углы, сотые доли градуса */
+
+/* Сотые доли в десятые с округлением: умножение на 6554 / 2^16 вместо деления на 10 */
+static int16_t centi_to_deci(int16_t value)
+{
+    int32_t scaled = ((int32_t)(value < 0 ? -value : value) * 6554 + 32768) >> 16;
+
+    return (int16_t)(value < 0 ? -scaled : scaled);
+}
+
+/* Получение: все выборки из кольцевого буфера драйвера через CIC-дециматор */
+static void stage_acquire(void)
+{
+    ADXL345_Sample_t sample;
+
+    /* При заполненном выходе остаток выборок ждет в кольцевом буфере драйвера до следующего запуска */
+    while ((uint8_t)(decimated_head - decimated_tail) < DECIMATED_SIZE && ADXL345_ReadSample(&sample))
+    {
+        if (decim_push(&decim, &sample, &decimated[decimated_head & (DECIMATED_SIZE - 1)]))
+        {
+            decimated_head++;
+        }
+    }
+}
+
+/* Фильтр: экспоненциальное сглаживание выхода дециматора */
+static void stage_filter(void)
+{
+    const ADXL345_Sample_t *sample;
+
+    for (; decimated_tail != decimated_head; decimated_tail++)
+    {
+        sample = &decimated[decimated_tail & (DECIMATED_SIZE - 1)];
+        filtered[0] += sample->x - (filtered[0] >> FILTER_SHIFT);
+        filtered[1] += sample->y - (filtered[1] >> FILTER_SHIFT);
+        filtered[2] += sample->z - (filtered[2] >> FILTER_SHIFT);
+    }
+}
+
+/* Углы крена и тангажа по сглаженному ускорению */
+static void stage_angles(void)
+{
+    int16_t x = (int16_t)(filtered[0] >> FILTER_SHIFT);
+    int16_t y = (int16_t)(filtered[1] >> FILTER_SHIFT);
+    int16_t z = (int16_t)(filtered[2] >> FILTER_SHIFT);
+
+    roll_cdeg = calculate_roll_cdeg(x, y, z);
+    pitch_cdeg = calculate_pitch_cdeg(x, y, z);
+}
+
+/* Значения: ускорения и углы в текстовые ячейки */
+static void stage_values(void)
+{
+    int16_t accel_cg[3];
+    uint8_t axis;
+
+    /* Ускорение в сотых долях g: 1g = 2^COUNTS_PER_G_LOG2 отсчетов, деление заменено сдвигом */
+    for (axis = 0; axis < 3; axis++)
+    {
+        accel_cg[axis] = (int16_t)(((filtered[axis] >> FILTER_SHIFT) * 100) >> COUNTS_PER_G_LOG2);
+    }
+
+    /* Углы в десятых долях градуса */
+    display_values(accel_cg, centi_to_deci(roll_cdeg), centi_to_deci(pitch_cdeg));
+}
+
+/* Движение: в покое конвейер переводится в медленный режим; сама задача медленной не становится */
+static void task_motion(void)
+{
+    sched_set_slow(!ADXL345_IsActive());
+}
+
+/* Часы: системное время в текстовые ячейки */
+static void task_clock(void)
+{
+    char time_str[9];
+
+    TIM4_GetTimeString(time_str);
+    display_time(time_str);
+}
+
+/* Вывод: фоновая передача изменившихся ячеек на дисплей */
+static void stage_render(void)
 {
-    // Вывод значений с единицами измерения
-    SSD1306_SetCursor(80, 0);
-    SSD1306_WriteString(time_str);
-
-    SSD1306_SetCursor(42, 2);
-    SSD1306_WriteString(ax_str);
-    SSD1306_SetCursor(75, 2);
-    SSD1306_WriteString("g");
-
-    SSD1306_SetCursor(42, 3);
-    SSD1306_WriteString(ay_str);
-    SSD1306_SetCursor(75, 3);
-    SSD1306_WriteString("g");
-
-    SSD1306_SetCursor(42, 4);
-    SSD1306_WriteString(az_str);
-    SSD1306_SetCursor(75, 4);
-    SSD1306_WriteString("g");
-
-    SSD1306_SetCursor(42, 5);
-    SSD1306_WriteString(roll_str);
-    SSD1306_SetCursor(75, 5);
-    SSD1306_WriteString("deg");
-
-    SSD1306_SetCursor(42, 6);
-    SSD1306_WriteString(pitch_str);
-    SSD1306_SetCursor(75, 6);
-    SSD1306_WriteString("deg");
+    SSD1306_TextFlushAsync();
 }
 
+/* Таблица задач в порядке обработки; бюджеты — при F_CPU = 16 МГц */
+static sched_task_t tasks[] = {
+    /* run            period slow  phase budget */
+    {stage_acquire, 10, 1000, 0, 500, 0, 0, 0, 0, 0},
+    {stage_filter, 10, 1000, 1, 100, 0, 0, 0, 0, 0},
+    {stage_angles, 50, 1000, 2, 500, 0, 0, 0, 0, 0},
+    {stage_values, 100, 1000, 3, 1000, 0, 0, 0, 0, 0},
+    {task_clock, 1000, 0, 4, 500, 0, 0, 0, 0, 0},
+    {stage_render, 100, 1000, 5, 300, 0, 0, 0, 0, 0},
+    {I2C_Service, 10, 0, 6, 100, 0, 0, 0, 0, 0},     // Сторожевая проверка фоновых транзакций I2C
+    {journal_service, 10, 0, 7, 300, 0, 0, 0, 0, 0}, // Фоновая запись событий в EEPROM
+    {task_motion, 10, 0, 8, 50, 0, 0, 0, 0, 0},      // Переключение медленного режима по ADXL345_IsActive
+};
+
 /**
  * @brief Точка входа в программу
  */
@@ -261,9 +452,6 @@ void main(void)
     // Статус инициализации
     uint8_t init_status = 1;
 
-    // Строка для хранения текущего времени
-    char timeStr[9];
-
     // Вызов функции инициализации
     init_status = init();
 
@@ -277,11 +465,7 @@ void main(void)
     // Предварительная отрисовка названий полей
     print_titles();
 
-    // Основной цикл программы
-    while (1)
-    {
-        TIM4_GetTimeString(timeStr);
-        display_data(timeStr, "0.0", "1.2", "-2.3", "0", "27.1");
-        delay(100); // Обновление 10 раз в секунду
-    }
-}
\ No newline at end of file
+    // Основной цикл программы: задачи по тику TIM4, между тиками — сон
+    decim_init(&decim, SENSOR_DECIM_LOG2);
+    sched_start(tasks, sizeof(tasks) / sizeof(tasks[0]));
+}
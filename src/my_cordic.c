@@ -0,0 +1,132 @@
+/**
+ * @file my_cordic.c
+ * @brief Реализация CORDIC в режиме векторизации
+ */
+
+#include "my_cordic.h"
+
+/* Дробные биты накопителя угла: единица равна 1/256 сотой доли градуса */
+#define CORDIC_ANGLE_FRAC 8
+
+/* Нормированный модуль входа лежит в [2^28, 2^29), с усилением 1.647 * sqrt(2) меньше 2^31 */
+#define CORDIC_NORM_BIT 28
+
+/* atan(2^-i) в сотых долях градуса << CORDIC_ANGLE_FRAC */
+static const int32_t cordic_angles[16] = {
+    1152000L, /* atan(2^-0) */
+    680065L,  /* atan(2^-1) */
+    359328L,  /* atan(2^-2) */
+    182400L,  /* atan(2^-3) */
+    91554L,   /* atan(2^-4) */
+    45822L,   /* atan(2^-5) */
+    22916L,   /* atan(2^-6) */
+    11459L,   /* atan(2^-7) */
+    5730L,    /* atan(2^-8) */
+    2865L,    /* atan(2^-9) */
+    1432L,    /* atan(2^-10) */
+    716L,     /* atan(2^-11) */
+    358L,     /* atan(2^-12) */
+    179L,     /* atan(2^-13) */
+    90L,      /* atan(2^-14) */
+    45L       /* atan(2^-15) */
+};
+
+/*
+ * Компенсация усиления: x * 0.6072529 суммой сдвигов
+ * 2^-1 + 2^-3 - 2^-6 - 2^-9 - 2^-12 + 2^-14 + 2^-16 - 2^-20 = 0.6072531
+ */
+static uint32_t cordic_gain(uint32_t x)
+{
+    return (x >> 1) + (x >> 3) - (x >> 6) - (x >> 9) - (x >> 12) + (x >> 14) + (x >> 16) - (x >> 20);
+}
+
+static int16_t cordic_vector(int32_t y, int32_t x, uint32_t *magnitude)
+{
+    uint32_t peak;
+    uint8_t shift = 0;
+    int32_t base = 0;
+    int32_t angle = 0;
+    int32_t dx;
+    uint8_t i;
+
+    peak = (uint32_t)((x < 0) ? -x : x) | (uint32_t)((y < 0) ? -y : y);
+    if (peak == 0)
+    {
+        if (magnitude)
+        {
+            *magnitude = 0;
+        }
+        return 0;
+    }
+
+    // Нормировка: старший бит наибольшей компоненты в позицию CORDIC_NORM_BIT
+    while (peak < (1UL << CORDIC_NORM_BIT))
+    {
+        peak <<= 1;
+        shift++;
+    }
+    x <<= shift;
+    y <<= shift;
+
+    // Левая полуплоскость: поворот на 180°, итерации сходятся только для |угла| < 99°
+    if (x < 0)
+    {
+        base = (y >= 0) ? 18000 : -18000;
+        x = -x;
+        y = -y;
+    }
+
+    for (i = 0; i < CORDIC_ITERATIONS; i++)
+    {
+        dx = x;
+        if (y > 0)
+        {
+            x += y >> i;
+            y -= dx >> i;
+            angle += cordic_angles[i];
+        }
+        else
+        {
+            x -= y >> i;
+            y += dx >> i;
+            angle -= cordic_angles[i];
+        }
+    }
+
+    if (magnitude)
+    {
+        *magnitude = (cordic_gain((uint32_t)x) + (1UL << shift >> 1)) >> shift;
+    }
+
+    angle = base + ((angle + (1L << (CORDIC_ANGLE_FRAC - 1))) >> CORDIC_ANGLE_FRAC);
+    if (angle > 18000)
+    {
+        angle -= 36000;
+    }
+    else if (angle < -18000)
+    {
+        angle += 36000;
+    }
+    return (int16_t)angle;
+}
+
+int16_t cordic_atan2(int32_t y, int32_t x)
+{
+    return cordic_vector(y, x, 0);
+}
+
+int16_t cordic_polar(int32_t y, int32_t x, uint32_t *magnitude)
+{
+    return cordic_vector(y, x, magnitude);
+}
+
+uint32_t cordic_magnitude3(int16_t x, int16_t y, int16_t z)
+{
+    uint32_t xz;
+    uint32_t xyz;
+
+    cordic_vector(z, x, &xz);
+    cordic_vector(y, (int32_t)xz, &xyz);
+
+    return xyz;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file my_cordic.h
+ * @brief CORDIC в режиме векторизации: угол и модуль вектора за один проход
+ *
+ * Вектор (x, y) поворачивается к оси X на углы ±atan(2^-i). Знак каждого поворота выбирается по
+ * знаку y, а сумма углов дает atan2(y, x). Каждая итерация выполняет два сдвига, три сложения
+ * и одно чтение таблицы, без умножений и делений. После поворота x равен модулю вектора,
+ * умноженному на усиление CORDIC (около 1.647). Усиление компенсируется суммой сдвигов.
+ *
+ * Перед итерациями вектор нормируется сдвигом влево. Поэтому точность не зависит от
+ * величины входа, а угловая погрешность определяется числом итераций @ref CORDIC_ITERATIONS.
+ */
+
+#ifndef MY_CORDIC_H
+#define MY_CORDIC_H
+
+#include <stdint.h>
+
+/**
+ * @brief Число итераций CORDIC, от 4 до 16
+ *
+ * Погрешность угла примерно равна atan(2^-(N-1)): 0.45° при N = 8, 0.012° при N = 14,
+ * 0.007° при N = 16. Погрешность модуля не превышает 0.5 при N >= 12.
+ * Время выполнения растет линейно с N.
+ */
+#ifndef CORDIC_ITERATIONS
+#define CORDIC_ITERATIONS 14
+#endif
+
+#if CORDIC_ITERATIONS < 4 || CORDIC_ITERATIONS > 16
+#error "CORDIC_ITERATIONS must be in range 4..16"
+#endif
+
+/**
+ * @brief Наибольший модуль входной компоненты
+ *
+ * При таком пределе нормированный вектор вместе с усилением CORDIC умещается в int32_t.
+ * Это позволяет передавать на вход модуль, полученный предыдущим вызовом.
+ */
+#define CORDIC_INPUT_MAX 65535L
+
+/**
+ * @brief Арктангенс двух переменных методом CORDIC.
+ *
+ * @param y Координата Y, |y| <= @ref CORDIC_INPUT_MAX
+ * @param x Координата X, |x| <= @ref CORDIC_INPUT_MAX
+ * @return Угол в сотых долях градуса от -18000 до 18000, 0 для нулевого вектора
+ */
+int16_t cordic_atan2(int32_t y, int32_t x);
+
+/**
+ * @brief Угол и модуль вектора за один проход CORDIC.
+ *
+ * @param y Координата Y, |y| <= @ref CORDIC_INPUT_MAX
+ * @param x Координата X, |x| <= @ref CORDIC_INPUT_MAX
+ * @param[out] magnitude Модуль вектора sqrt(x^2 + y^2), округленный до целого
+ * @return Угол в сотых долях градуса от -18000 до 18000, 0 для нулевого вектора
+ */
+int16_t cordic_polar(int32_t y, int32_t x, uint32_t *magnitude);
+
+/**
+ * @brief Модуль полного ускорения sqrt(x^2 + y^2 + z^2).
+ *
+ * Два прохода CORDIC: модуль (x, z), затем модуль полученного значения и y.
+ *
+ * @param x Данные ускорения по оси X
+ * @param y Данные ускорения по оси Y
+ * @param z Данные ускорения по оси Z
+ * @return Модуль вектора в тех же единицах, что и входные данные
+ */
+uint32_t cordic_magnitude3(int16_t x, int16_t y, int16_t z);
+
+#endif // MY_CORDIC_H
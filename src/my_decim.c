@@ -0,0 +1,118 @@
+/**
+ * @file my_decim.c
+ * @brief Реализация дециматора CIC
+ */
+
+#include "my_decim.h"
+
+/* Насыщение 32-битного результата до int16_t */
+static int16_t decim_saturate(int32_t value)
+{
+    if (value > 32767)
+    {
+        return 32767;
+    }
+    if (value < -32768)
+    {
+        return -32768;
+    }
+    return (int16_t)value;
+}
+
+/* Гребенки одной оси и нормировка на усиление R^ORDER */
+static int16_t decim_output(decim_t *decim, uint8_t axis)
+{
+    uint32_t value = decim->integrator[axis][DECIM_ORDER - 1];
+    uint32_t delayed;
+    uint8_t shift = (uint8_t)(DECIM_ORDER * decim->log2_ratio);
+    int32_t result;
+    uint8_t k;
+
+    for (k = 0; k < DECIM_ORDER; k++)
+    {
+        delayed = decim->comb[axis][k];
+        decim->comb[axis][k] = value;
+        value -= delayed;
+    }
+
+    result = (int32_t)value;
+    if (shift > DECIM_FRAC_BITS)
+    {
+        /* Деление с округлением к ближайшему */
+        shift -= DECIM_FRAC_BITS;
+        result = (result + ((int32_t)1 << (shift - 1))) >> shift;
+    }
+    else
+    {
+        result <<= (DECIM_FRAC_BITS - shift);
+    }
+
+    return decim_saturate(result);
+}
+
+void decim_init(decim_t *decim, uint8_t log2_ratio)
+{
+    uint8_t axis, k;
+
+    if (log2_ratio == 0)
+    {
+        log2_ratio = 1;
+    }
+    if (log2_ratio > DECIM_MAX_LOG2_RATIO)
+    {
+        log2_ratio = DECIM_MAX_LOG2_RATIO;
+    }
+
+    for (axis = 0; axis < DECIM_AXES; axis++)
+    {
+        for (k = 0; k < DECIM_ORDER; k++)
+        {
+            decim->integrator[axis][k] = 0;
+            decim->comb[axis][k] = 0;
+        }
+    }
+    decim->last_timestamp = 0;
+    decim->log2_ratio = log2_ratio;
+    decim->phase = 0;
+}
+
+uint8_t decim_push(decim_t *decim, const ADXL345_Sample_t *in, ADXL345_Sample_t *out)
+{
+    int16_t input[DECIM_AXES];
+    uint32_t acc;
+    uint32_t period;
+    uint8_t ratio = (uint8_t)(1 << decim->log2_ratio);
+    uint8_t axis, k;
+
+    input[0] = in->x;
+    input[1] = in->y;
+    input[2] = in->z;
+
+    /* Интеграторы работают на входной частоте */
+    for (axis = 0; axis < DECIM_AXES; axis++)
+    {
+        acc = (uint32_t)(int32_t)input[axis];
+        for (k = 0; k < DECIM_ORDER; k++)
+        {
+            acc += decim->integrator[axis][k];
+            decim->integrator[axis][k] = acc;
+        }
+    }
+
+    period = in->timestamp - decim->last_timestamp;
+    decim->last_timestamp = in->timestamp;
+
+    if (++decim->phase < ratio)
+    {
+        return 0;
+    }
+    decim->phase = 0;
+
+    /* Гребенки — на выходной частоте, раз в R входных выборок */
+    out->x = decim_output(decim, 0);
+    out->y = decim_output(decim, 1);
+    out->z = decim_output(decim, 2);
+    out->timestamp = in->timestamp - (period * (DECIM_ORDER * (ratio - 1))) / 2;
+
+    return 1;
+}
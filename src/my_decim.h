@@ -0,0 +1,77 @@
+/**
+ * @file my_decim.h
+ * @brief Дециматор CIC для выборок акселерометра
+ *
+ * Каскадный интегратор-гребенчатый фильтр (CIC) порядка @ref DECIM_ORDER с коэффициентом
+ * децимации R = 2^log2_ratio. Акселерометр работает на повышенной частоте (до 3200 Гц),
+ * дециматор усредняет R выборок с АЧХ (sin(πfR)/sin(πf))^N и выдает одну выборку на выходной
+ * частоте ODR / R. Шум уменьшается примерно в sqrt(R) раз, поэтому выходные значения имеют
+ * @ref DECIM_FRAC_BITS дополнительных дробных бит.
+ *
+ * Вся арифметика целочисленная: на каждую входную выборку N сложений 32-битных чисел на ось,
+ * на каждую выходную — N вычитаний и один сдвиг. Переполнение интеграторов допустимо:
+ * арифметика по модулю 2^32 дает верный результат гребенок, пока выход умещается в 32 бита.
+ */
+
+#ifndef MY_DECIM_H
+#define MY_DECIM_H
+
+#include <stdint.h>
+#include "adxl345.h"
+
+/** @brief Порядок фильтра (число интеграторов и гребенок) */
+#define DECIM_ORDER 3
+
+/** @brief Наибольший log2 коэффициента децимации: 16 бит входа + ORDER * 5 бит роста = 31 бит */
+#define DECIM_MAX_LOG2_RATIO 5
+
+/**
+ * @brief Дополнительные дробные биты выхода
+ *
+ * Выход равен среднему входу, умноженному на 2^DECIM_FRAC_BITS. Отсчеты ADXL345 в режиме
+ * Full Resolution не превышают ±4096, поэтому результат умещается в int16_t.
+ */
+#ifndef DECIM_FRAC_BITS
+#define DECIM_FRAC_BITS 2
+#endif
+
+/** @brief Количество осей */
+#define DECIM_AXES 3
+
+/**
+ * @struct decim_t
+ * @brief Состояние дециматора
+ */
+typedef struct
+{
+    uint32_t integrator[DECIM_AXES][DECIM_ORDER]; /**< Интеграторы на входной частоте */
+    uint32_t comb[DECIM_AXES][DECIM_ORDER];       /**< Задержки гребенок на выходной частоте */
+    uint32_t last_timestamp;                      /**< Отметка времени предыдущей входной выборки */
+    uint8_t log2_ratio;                           /**< log2 коэффициента децимации */
+    uint8_t phase;                                /**< Номер входной выборки внутри окна R */
+} decim_t;
+
+/**
+ * @brief Инициализация дециматора
+ *
+ * @param[out] decim      Состояние дециматора
+ * @param      log2_ratio log2 коэффициента децимации (1..@ref DECIM_MAX_LOG2_RATIO)
+ */
+void decim_init(decim_t *decim, uint8_t log2_ratio);
+
+/**
+ * @brief Подача входной выборки
+ *
+ * Отметка времени выходной выборки исправлена на групповую задержку фильтра
+ * ORDER * (R - 1) / 2 входных периодов. Первые ORDER выходных выборок после
+ * инициализации содержат переходный процесс.
+ *
+ * @param[in,out] decim Состояние дециматора
+ * @param[in]     in    Входная выборка
+ * @param[out]    out   Выходная выборка (значения умножены на 2^@ref DECIM_FRAC_BITS)
+ * @retval 1 Готова выходная выборка
+ * @retval 0 Выход на этом шаге не формируется
+ */
+uint8_t decim_push(decim_t *decim, const ADXL345_Sample_t *in, ADXL345_Sample_t *out);
+
+#endif /* MY_DECIM_H */
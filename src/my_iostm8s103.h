@@ -1,6 +1,12 @@
 #ifndef IOSTM8S103_H
 #define IOSTM8S103_H
 
+/* CPU section */
+/* Сохраняет CC (маски прерываний I1/I0) и запрещает прерывания; значение передается в IRQ_RESTORE */
+#define IRQ_SAVE_DISABLE() ((unsigned char)_asm("push cc\n\tpop a\n\tsim"))
+/* Восстанавливает CC: прерывания снова разрешаются, только если были разрешены до IRQ_SAVE_DISABLE */
+#define IRQ_RESTORE(cc) _asm("push a\n\tpop cc", (unsigned char)(cc))
+
 /* PORTS section */
 /* Port A */
 #define PA_ODR (*(volatile char *)0x5000) /* Data Output Latch reg */
@@ -1,4 +1,5 @@
 #include "my_math.h"
+#include "my_math_tables.h"
 
 // Коэффициент для перевода радиан в градусы
 #define RAD_TO_DEG 57.29577951308232f
@@ -7,6 +8,17 @@
 #define SQRT_ITERATIONS 10
 #define ATAN_ITERATIONS 10
 
+// Аппроксимация арктангенса в фиксированной точке
+#define ATAN_Q15_ONE 32768UL  // 1.0 в Q15
+#define ATAN_Q15_HALF 16384UL // 0.5 в Q15, для округления
+#define ATAN_POLY_C0 1402UL   // Коэффициенты поправки, сотые доли градуса
+#define ATAN_POLY_C1 380UL
+
+// Интерполяция по таблицам: аргумент в Q15 на [0, 1]
+#define LUT_SHIFT (15 - MATH_TABLE_LOG2)
+#define LUT_ATAN_FRAC 2     // Дробные биты math_atan_table
+#define LUT_THIRD_Q17 43691UL // 1/3 в Q17: отображение [1/4, 1] -> [0, 1] без деления
+
 float my_sqrt(float x)
 {
     if (x <= 0.0f)
@@ -101,4 +113,209 @@ float calculate_pitch(int16_t x, int16_t y, int16_t z)
         denominator = 0.0001f; // Избегаем деления на ноль
     float angle_rad = my_atan2(-fx, denominator);
     return angle_rad * RAD_TO_DEG;
-}
\ No newline at end of file
+}
+
+uint16_t my_isqrt(uint32_t x)
+{
+    uint32_t result = 0;
+    uint32_t bit = 1UL << 30; // Старшая степень четверки в 32 битах
+
+    while (bit > x)
+    {
+        bit >>= 2;
+    }
+
+    // Побитовое извлечение корня: только сдвиги, сложения и сравнения
+    while (bit != 0)
+    {
+        if (x >= result + bit)
+        {
+            x -= result + bit;
+            result = (result >> 1) + bit;
+        }
+        else
+        {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (uint16_t)result;
+}
+
+/*
+ * atan(t) в сотых долях градуса для t = [0, 1] в Q15:
+ * atan(t) ~ 45 t + t (1 - t) (14.02 + 3.80 t) градусов
+ */
+static int16_t atan_unit_cdeg(uint16_t t)
+{
+    uint32_t base = (4500UL * t + ATAN_Q15_HALF) >> 15;
+    uint32_t parabola = ((uint32_t)t * (ATAN_Q15_ONE - t)) >> 15;
+    uint32_t correction = ATAN_POLY_C0 + ((ATAN_POLY_C1 * t) >> 15);
+
+    return (int16_t)(base + ((parabola * correction + ATAN_Q15_HALF) >> 15));
+}
+
+/* Приведение atan2 к первому октанту и вычисление atan(t), t = [0, 1] в Q15, функцией unit */
+static int16_t atan2_octant(int32_t y, int32_t x, int16_t (*unit)(uint16_t))
+{
+    uint32_t ay = (y < 0) ? 0UL - (uint32_t)y : (uint32_t)y;
+    uint32_t ax = (x < 0) ? 0UL - (uint32_t)x : (uint32_t)x;
+    int16_t angle;
+
+    if (ax == 0 && ay == 0)
+    {
+        return 0; // Неопределено, возвращаем 0
+    }
+
+    // Больший катет меньше 2^16, чтобы сдвиг на 15 разрядов не переполнил 32 бита; отношение сохраняется
+    while ((ax | ay) >= 0x10000UL)
+    {
+        ax >>= 1;
+        ay >>= 1;
+    }
+
+    // Приведение к первому октанту: отношение меньшего катета к большему в Q15
+    if (ay <= ax)
+    {
+        angle = unit((uint16_t)((ay << 15) / ax));
+    }
+    else
+    {
+        angle = 9000 - unit((uint16_t)((ax << 15) / ay));
+    }
+
+    if (x < 0)
+    {
+        angle = 18000 - angle;
+    }
+    return (y < 0) ? -angle : angle;
+}
+
+int16_t my_atan2_cdeg(int32_t y, int32_t x)
+{
+    return atan2_octant(y, x, atan_unit_cdeg);
+}
+
+/* Линейная интерполяция таблицы, position в Q15 на [0, 1] */
+static uint16_t lut_interpolate(const uint16_t *table, uint16_t position)
+{
+    uint8_t index = (uint8_t)(position >> LUT_SHIFT);
+    int32_t frac = position & ((1U << LUT_SHIFT) - 1);
+    int32_t delta;
+
+    if (index >= MATH_TABLE_SIZE - 1)
+    {
+        return table[MATH_TABLE_SIZE - 1];
+    }
+    delta = (int32_t)table[index + 1] - table[index];
+    return (uint16_t)(table[index] + ((delta * frac + (1L << (LUT_SHIFT - 1))) >> LUT_SHIFT));
+}
+
+int16_t my_atan_lut_cdeg(uint16_t t)
+{
+    return (int16_t)((lut_interpolate(math_atan_table, t) + (1U << (LUT_ATAN_FRAC - 1))) >> LUT_ATAN_FRAC);
+}
+
+int16_t my_atan2_lut_cdeg(int32_t y, int32_t x)
+{
+    return atan2_octant(y, x, my_atan_lut_cdeg);
+}
+
+/*
+ * Нормировка x << shift в [2^30, 2^32) с четным shift и позиция мантиссы u = [1/4, 1)
+ * в таблицах sqrt/rsqrt: (u - 1/4) / (3/4) в Q15
+ */
+static uint16_t lut_normalize(uint32_t x, uint8_t *shift)
+{
+    *shift = 0;
+    while (x < (1UL << 30))
+    {
+        x <<= 2;
+        *shift += 2;
+    }
+    return (uint16_t)((((x - (1UL << 30)) >> 15) * LUT_THIRD_Q17) >> 17);
+}
+
+uint16_t my_sqrt_lut(uint32_t x)
+{
+    uint8_t shift;
+    uint16_t position;
+    uint32_t root;
+
+    if (x == 0)
+    {
+        return 0;
+    }
+
+    // sqrt(x) = sqrt(u) * 2^16 / 2^(shift / 2)
+    position = lut_normalize(x, &shift);
+    root = lut_interpolate(math_sqrt_table, position);
+    shift >>= 1;
+    return (uint16_t)((root + ((1UL << shift) >> 1)) >> shift);
+}
+
+uint16_t my_rsqrt_lut(uint32_t x)
+{
+    uint8_t shift;
+    uint16_t position;
+
+    if (x == 0)
+    {
+        return 0xFFFF; // Насыщение
+    }
+
+    // 1/sqrt(x) = rsqrt(u) * 2^(shift / 2 - 16), таблица в Q15, результат в Q16
+    position = lut_normalize(x, &shift);
+    return lut_interpolate(math_rsqrt_table, position) >> (15 - (shift >> 1));
+}
+
+/*
+ * Сдвиг, выравнивающий наибольшую по модулю компоненту к 2^14: малые векторы
+ * не теряют точность на целочисленном корне; сумма двух квадратов не превышает 2^31
+ */
+static uint8_t angle_norm_shift(int16_t x, int16_t y, int16_t z)
+{
+    int32_t peak = (x < 0) ? -(int32_t)x : x;
+    int32_t ay = (y < 0) ? -(int32_t)y : y;
+    int32_t az = (z < 0) ? -(int32_t)z : z;
+    uint8_t shift = 0;
+
+    if (ay > peak)
+    {
+        peak = ay;
+    }
+    if (az > peak)
+    {
+        peak = az;
+    }
+    if (peak == 0)
+    {
+        return 0;
+    }
+
+    while (peak < (1L << 14))
+    {
+        peak <<= 1;
+        shift++;
+    }
+    return shift;
+}
+
+int16_t calculate_roll_cdeg(int16_t x, int16_t y, int16_t z)
+{
+    uint8_t shift = angle_norm_shift(x, y, z);
+    int32_t sx = (int32_t)x << shift;
+    int32_t sz = (int32_t)z << shift;
+
+    return my_atan2_cdeg((int32_t)y << shift, my_isqrt((uint32_t)(sx * sx) + (uint32_t)(sz * sz)));
+}
+
+int16_t calculate_pitch_cdeg(int16_t x, int16_t y, int16_t z)
+{
+    uint8_t shift = angle_norm_shift(x, y, z);
+    int32_t sy = (int32_t)y << shift;
+    int32_t sz = (int32_t)z << shift;
+
+    return my_atan2_cdeg(-((int32_t)x << shift), my_isqrt((uint32_t)(sy * sy) + (uint32_t)(sz * sz)));
+}
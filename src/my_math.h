@@ -33,6 +33,8 @@ float my_atan2(float y, float x);
 /**
  * @brief Вычисление угла крена (вращение вокруг оси X).
  *
+ * Эталонная реализация на плавающей точке, см. @ref calculate_roll_cdeg.
+ *
  * @param x Данные ускорения по оси X
  * @param y Данные ускорения по оси Y
  * @param z Данные ускорения по оси Z
@@ -43,6 +45,8 @@ float calculate_roll(int16_t x, int16_t y, int16_t z);
 /**
  * @brief Вычисление угла тангажа (вращение вокруг оси Y).
  *
+ * Эталонная реализация на плавающей точке, см. @ref calculate_pitch_cdeg.
+ *
  * @param x Данные ускорения по оси X
  * @param y Данные ускорения по оси Y
  * @param z Данные ускорения по оси Z
@@ -50,4 +54,98 @@ float calculate_roll(int16_t x, int16_t y, int16_t z);
  */
 float calculate_pitch(int16_t x, int16_t y, int16_t z);
 
+/**
+ * @brief Целочисленный квадратный корень.
+ *
+ * Побитовый метод без деления и плавающей точки.
+ *
+ * @param x Входное число
+ * @return Наибольшее r, для которого r * r <= x
+ */
+uint16_t my_isqrt(uint32_t x);
+
+/**
+ * @brief Арктангенс двух переменных в фиксированной точке.
+ *
+ * Отношение меньшей компоненты к большей вычисляется в Q15 (одно целочисленное деление),
+ * арктангенс на [0, 1] приближается полиномом 45 t + t (1 - t) (14.02 + 3.80 t) градусов.
+ * Погрешность не превышает 0.1 градуса.
+ *
+ * @param y Координата Y
+ * @param x Координата X
+ * @return Угол в сотых долях градуса от -18000 до 18000
+ */
+int16_t my_atan2_cdeg(int32_t y, int32_t x);
+
+/**
+ * @brief Вычисление угла крена в фиксированной точке.
+ *
+ * Целочисленный аналог @ref calculate_roll для процессора без FPU. Вектор предварительно
+ * нормируется сдвигом, поэтому погрешность не превышает 0.1 градуса (СКО около 0.06 градуса)
+ * во всем диапазоне int16_t, включая малые значения.
+ *
+ * @param x Данные ускорения по оси X
+ * @param y Данные ускорения по оси Y
+ * @param z Данные ускорения по оси Z
+ * @return Угол крена в сотых долях градуса от -9000 до 9000
+ */
+int16_t calculate_roll_cdeg(int16_t x, int16_t y, int16_t z);
+
+/**
+ * @brief Вычисление угла тангажа в фиксированной точке.
+ *
+ * Целочисленный аналог @ref calculate_pitch, погрешность как у @ref calculate_roll_cdeg.
+ *
+ * @param x Данные ускорения по оси X
+ * @param y Данные ускорения по оси Y
+ * @param z Данные ускорения по оси Z
+ * @return Угол тангажа в сотых долях градуса от -9000 до 9000
+ */
+int16_t calculate_pitch_cdeg(int16_t x, int16_t y, int16_t z);
+
+/**
+ * @brief Арктангенс по таблице с линейной интерполяцией.
+ *
+ * Таблица @ref math_atan_table формируется tools/gen_math_tables.c. Ее размер задается
+ * @ref MATH_TABLE_LOG2, погрешность для каждого размера указана в my_math_tables.h.
+ *
+ * @param t Аргумент от 0 до 1 в Q15 (0..32768)
+ * @return atan(t) в сотых долях градуса от 0 до 4500
+ */
+int16_t my_atan_lut_cdeg(uint16_t t);
+
+/**
+ * @brief Арктангенс двух переменных по таблице.
+ *
+ * Приведение к первому октанту как в @ref my_atan2_cdeg, atan вычисляется @ref my_atan_lut_cdeg.
+ *
+ * @param y Координата Y
+ * @param x Координата X
+ * @return Угол в сотых долях градуса от -18000 до 18000
+ */
+int16_t my_atan2_lut_cdeg(int32_t y, int32_t x);
+
+/**
+ * @brief Квадратный корень по таблице.
+ *
+ * Аргумент нормируется сдвигом на четное число бит, корень мантиссы берется из
+ * @ref math_sqrt_table с интерполяцией. Без деления.
+ *
+ * @param x Входное число
+ * @return sqrt(x), округленный до целого
+ */
+uint16_t my_sqrt_lut(uint32_t x);
+
+/**
+ * @brief Обратный квадратный корень по таблице.
+ *
+ * Используется для нормировки вектора без деления: v * rsqrt(|v|^2).
+ * Результат квантуется в Q16, поэтому при x > 2^16 к погрешности таблицы добавляется
+ * погрешность округления до 1/(65536/sqrt(x)).
+ *
+ * @param x Входное число
+ * @return 1/sqrt(x) в Q16 (для x = 0 и x = 1 насыщение до 0xFFFF)
+ */
+uint16_t my_rsqrt_lut(uint32_t x);
+
 #endif // MY_MATH_H
\ No newline at end of file
@@ -0,0 +1,192 @@
+/**
+ * @file my_math_tables.h
+ * @brief Таблицы atan/sqrt/rsqrt для интерполяции, хранимые во FLASH
+ *
+ * Файл сформирован tools/gen_math_tables.c, не редактировать вручную.
+ *
+ * Каждая таблица содержит MATH_TABLE_SIZE = 2^MATH_TABLE_LOG2 + 1 равноотстоящих точек:
+ * - math_atan_table:  atan(t), t = [0, 1], сотые доли градуса << 2;
+ * - math_sqrt_table:  sqrt(u), u = [1/4, 1], Q16 (насыщение до 65535);
+ * - math_rsqrt_table: 1/sqrt(u), u = [1/4, 1], Q15 (насыщение до 65535).
+ */
+
+#ifndef MY_MATH_TABLES_H
+#define MY_MATH_TABLES_H
+
+#include <stdint.h>
+
+/** @brief log2 числа интервалов таблиц, от 4 до 7 */
+#ifndef MATH_TABLE_LOG2
+#define MATH_TABLE_LOG2 5
+#endif
+
+/** @brief Число точек таблицы */
+#define MATH_TABLE_SIZE ((1 << MATH_TABLE_LOG2) + 1)
+
+#if MATH_TABLE_LOG2 == 4
+
+/*
+ * 17 точек, 102 байт FLASH на все таблицы. Наибольшая погрешность интерполяции:
+ * atan 0.0199 градуса, sqrt 9.4e-04, rsqrt 2.8e-03 (относительная)
+ */
+#define MATH_TABLE_ATAN_ERROR_CDEG 2
+
+static const uint16_t math_atan_table[MATH_TABLE_SIZE] = {
+        0,  1431,  2850,  4248,  5614,  6942,  8222,  9452,
+    10626, 11743, 12802, 13803, 14748, 15638, 16474, 17261,
+    18000,
+};
+static const uint16_t math_sqrt_table[MATH_TABLE_SIZE] = {
+    32768, 35708, 38424, 40960, 43348, 45611, 47767, 49830,
+    51811, 53719, 55561, 57344, 59073, 60753, 62388, 63982,
+    65535,
+};
+static const uint16_t math_rsqrt_table[MATH_TABLE_SIZE] = {
+    65535, 60140, 55889, 52429, 49541, 47082, 44957, 43096,
+    41449, 39977, 38651, 37449, 36353, 35347, 34421, 33564,
+    32768,
+};
+
+#elif MATH_TABLE_LOG2 == 5
+
+/*
+ * 33 точек, 198 байт FLASH на все таблицы. Наибольшая погрешность интерполяции:
+ * atan 0.0062 градуса, sqrt 2.6e-04, rsqrt 7.5e-04 (относительная)
+ */
+#define MATH_TABLE_ATAN_ERROR_CDEG 1
+
+static const uint16_t math_atan_table[MATH_TABLE_SIZE] = {
+        0,   716,  1431,  2142,  2850,  3552,  4248,  4936,
+     5614,  6283,  6942,  7588,  8222,  8844,  9452, 10046,
+    10626, 11192, 11743, 12280, 12802, 13310, 13803, 14283,
+    14748, 15199, 15638, 16062, 16474, 16874, 17261, 17636,
+    18000,
+};
+static const uint16_t math_sqrt_table[MATH_TABLE_SIZE] = {
+    32768, 34270, 35708, 37091, 38424, 39712, 40960, 42171,
+    43348, 44494, 45611, 46702, 47767, 48809, 49830, 50830,
+    51811, 52773, 53719, 54647, 55561, 56459, 57344, 58215,
+    59073, 59919, 60753, 61576, 62388, 63190, 63982, 64763,
+    65535,
+};
+static const uint16_t math_rsqrt_table[MATH_TABLE_SIZE] = {
+    65535, 62664, 60140, 57898, 55889, 54076, 52429, 50923,
+    49541, 48265, 47082, 45983, 44957, 43997, 43096, 42248,
+    41449, 40693, 39977, 39297, 38651, 38036, 37449, 36889,
+    36353, 35840, 35347, 34875, 34421, 33985, 33564, 33159,
+    32768,
+};
+
+#elif MATH_TABLE_LOG2 == 6
+
+/*
+ * 65 точек, 390 байт FLASH на все таблицы. Наибольшая погрешность интерполяции:
+ * atan 0.0034 градуса, sqrt 8.3e-05, rsqrt 2.0e-04 (относительная)
+ */
+#define MATH_TABLE_ATAN_ERROR_CDEG 1
+
+static const uint16_t math_atan_table[MATH_TABLE_SIZE] = {
+        0,   358,   716,  1074,  1431,  1787,  2142,  2497,
+     2850,  3202,  3552,  3901,  4248,  4593,  4936,  5276,
+     5614,  5950,  6283,  6614,  6942,  7266,  7588,  7907,
+     8222,  8535,  8844,  9149,  9452,  9751, 10046, 10338,
+    10626, 10911, 11192, 11469, 11743, 12013, 12280, 12543,
+    12802, 13058, 13310, 13558, 13803, 14045, 14283, 14517,
+    14748, 14975, 15199, 15420, 15638, 15852, 16062, 16270,
+    16474, 16676, 16874, 17069, 17261, 17450, 17636, 17820,
+    18000,
+};
+static const uint16_t math_sqrt_table[MATH_TABLE_SIZE] = {
+    32768, 33527, 34270, 34996, 35708, 36406, 37091, 37763,
+    38424, 39073, 39712, 40341, 40960, 41570, 42171, 42763,
+    43348, 43925, 44494, 45056, 45611, 46160, 46702, 47237,
+    47767, 48291, 48809, 49322, 49830, 50332, 50830, 51323,
+    51811, 52294, 52773, 53248, 53719, 54185, 54647, 55106,
+    55561, 56012, 56459, 56903, 57344, 57781, 58215, 58646,
+    59073, 59498, 59919, 60338, 60753, 61166, 61576, 61984,
+    62388, 62790, 63190, 63587, 63982, 64374, 64763, 65151,
+    65535,
+};
+static const uint16_t math_rsqrt_table[MATH_TABLE_SIZE] = {
+    65535, 64052, 62664, 61363, 60140, 58987, 57898, 56867,
+    55889, 54960, 54076, 53233, 52429, 51660, 50923, 50218,
+    49541, 48890, 48265, 47663, 47082, 46523, 45983, 45462,
+    44957, 44470, 43997, 43540, 43096, 42666, 42248, 41843,
+    41449, 41065, 40693, 40330, 39977, 39632, 39297, 38970,
+    38651, 38340, 38036, 37739, 37449, 37166, 36889, 36618,
+    36353, 36093, 35840, 35591, 35347, 35109, 34875, 34646,
+    34421, 34201, 33985, 33772, 33564, 33360, 33159, 32962,
+    32768,
+};
+
+#elif MATH_TABLE_LOG2 == 7
+
+/*
+ * 129 точек, 774 байт FLASH на все таблицы. Наибольшая погрешность интерполяции:
+ * atan 0.0026 градуса, sqrt 3.9e-05, rsqrt 5.6e-05 (относительная)
+ */
+#define MATH_TABLE_ATAN_ERROR_CDEG 1
+
+static const uint16_t math_atan_table[MATH_TABLE_SIZE] = {
+        0,   179,   358,   537,   716,   895,  1074,  1252,
+     1431,  1609,  1787,  1965,  2142,  2320,  2497,  2674,
+     2850,  3026,  3202,  3377,  3552,  3727,  3901,  4075,
+     4248,  4421,  4593,  4764,  4936,  5106,  5276,  5446,
+     5614,  5783,  5950,  6117,  6283,  6449,  6614,  6778,
+     6942,  7104,  7266,  7428,  7588,  7748,  7907,  8065,
+     8222,  8379,  8535,  8690,  8844,  8997,  9149,  9301,
+     9452,  9602,  9751,  9899, 10046, 10192, 10338, 10482,
+    10626, 10769, 10911, 11052, 11192, 11331, 11469, 11607,
+    11743, 11879, 12013, 12147, 12280, 12412, 12543, 12673,
+    12802, 12930, 13058, 13184, 13310, 13435, 13558, 13681,
+    13803, 13925, 14045, 14164, 14283, 14400, 14517, 14633,
+    14748, 14862, 14975, 15088, 15199, 15310, 15420, 15529,
+    15638, 15745, 15852, 15957, 16062, 16167, 16270, 16373,
+    16474, 16575, 16676, 16775, 16874, 16972, 17069, 17165,
+    17261, 17356, 17450, 17544, 17636, 17728, 17820, 17910,
+    18000,
+};
+static const uint16_t math_sqrt_table[MATH_TABLE_SIZE] = {
+    32768, 33150, 33527, 33900, 34270, 34635, 34996, 35354,
+    35708, 36059, 36406, 36750, 37091, 37429, 37763, 38095,
+    38424, 38750, 39073, 39394, 39712, 40028, 40341, 40652,
+    40960, 41266, 41570, 41871, 42171, 42468, 42763, 43057,
+    43348, 43637, 43925, 44210, 44494, 44776, 45056, 45334,
+    45611, 45886, 46160, 46431, 46702, 46970, 47237, 47503,
+    47767, 48030, 48291, 48551, 48809, 49067, 49322, 49577,
+    49830, 50082, 50332, 50582, 50830, 51077, 51323, 51567,
+    51811, 52053, 52294, 52534, 52773, 53011, 53248, 53484,
+    53719, 53952, 54185, 54417, 54647, 54877, 55106, 55334,
+    55561, 55787, 56012, 56236, 56459, 56682, 56903, 57124,
+    57344, 57563, 57781, 57999, 58215, 58431, 58646, 58860,
+    59073, 59286, 59498, 59709, 59919, 60129, 60338, 60546,
+    60753, 60960, 61166, 61372, 61576, 61780, 61984, 62186,
+    62388, 62590, 62790, 62991, 63190, 63389, 63587, 63785,
+    63982, 64178, 64374, 64569, 64763, 64957, 65151, 65344,
+    65535,
+};
+static const uint16_t math_rsqrt_table[MATH_TABLE_SIZE] = {
+    65535, 64781, 64052, 63347, 62664, 62004, 61363, 60742,
+    60140, 59555, 58987, 58435, 57898, 57376, 56867, 56372,
+    55889, 55419, 54960, 54513, 54076, 53650, 53233, 52826,
+    52429, 52040, 51660, 51288, 50923, 50567, 50218, 49876,
+    49541, 49212, 48890, 48574, 48265, 47961, 47663, 47370,
+    47082, 46800, 46523, 46251, 45983, 45720, 45462, 45207,
+    44957, 44711, 44470, 44232, 43997, 43767, 43540, 43316,
+    43096, 42879, 42666, 42456, 42248, 42044, 41843, 41644,
+    41449, 41256, 41065, 40878, 40693, 40510, 40330, 40152,
+    39977, 39803, 39632, 39464, 39297, 39133, 38970, 38810,
+    38651, 38494, 38340, 38187, 38036, 37887, 37739, 37593,
+    37449, 37307, 37166, 37027, 36889, 36753, 36618, 36485,
+    36353, 36222, 36093, 35966, 35840, 35715, 35591, 35469,
+    35347, 35228, 35109, 34991, 34875, 34760, 34646, 34533,
+    34421, 34310, 34201, 34092, 33985, 33878, 33772, 33668,
+    33564, 33461, 33360, 33259, 33159, 33060, 32962, 32864,
+    32768,
+};
+
+#else
+#error "MATH_TABLE_LOG2 must be in range 4..7"
+#endif
+
+#endif // MY_MATH_TABLES_H
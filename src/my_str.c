@@ -2,60 +2,141 @@
  * @file my_str.c
  * @brief Реализация функций для работы со строками.
  *
- * Этот файл содержит реализацию функции преобразования целого числа в строку.
+ * Этот файл содержит реализацию функций преобразования целых чисел и чисел с фиксированной
+ * точкой в строку.
  */
 
 #include "my_str.h"
 
+/* Степени десяти для разложения на цифры без деления */
+#define STR_POW10_COUNT 10
+
+static const uint32_t str_pow10[STR_POW10_COUNT] = {
+    1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL, 10000000UL, 100000000UL, 1000000000UL};
+
 /**
  * @brief Преобразует целое число в строку.
  *
  * Функция преобразует указанное 32-битное целое число в строку и записывает его
  * в переданный буфер. Поддерживается преобразование отрицательных чисел.
  * Буфер должен быть достаточного размера (не менее 12 байт для int32_t).
+ * Частный случай @ref fixed_to_str без дробной части и выравнивания.
  *
  * @param[in] num Целое число, которое необходимо преобразовать.
  * @param[out] str Указатель на строковый буфер, в который будет записан результат.
  */
 void int_to_str(int32_t num, char *str)
 {
-    char temp[12]; /* Временный буфер для хранения перевернутого числа */
-    int8_t i = 0;
-    int8_t j;
-    uint8_t is_negative = 0; /* Флаг для отрицательных чисел */
+    fixed_to_str(num, 0, 0, ' ', str);
+}
+
+/* Количество выводимых цифр: все значащие, но не меньше frac_digits + 1 */
+static uint8_t fixed_digits(uint32_t magnitude, uint8_t frac_digits)
+{
+    uint8_t count = frac_digits + 1;
 
-    /* Обработка случая, когда число равно 0 */
-    if (num == 0)
+    while (count < STR_POW10_COUNT && magnitude >= str_pow10[count])
     {
-        str[i++] = '0';
-        str[i] = '\0';
-        return;
+        count++;
     }
+    return count;
+}
+
+/* Модуль в беззнаковом виде: корректен и для -2^31 */
+static uint32_t fixed_magnitude(int32_t value)
+{
+    return (value < 0) ? (uint32_t)0 - (uint32_t)value : (uint32_t)value;
+}
+
+uint8_t fixed_length(int32_t value, uint8_t frac_digits)
+{
+    return fixed_digits(fixed_magnitude(value), frac_digits) + (frac_digits != 0) + (value < 0);
+}
+
+/**
+ * @brief Выводит число с фиксированной точкой посимвольно через emit.
+ *
+ * Модуль числа раскладывается на цифры от старшего разряда к младшему: каждая цифра равна
+ * количеству вычитаний соответствующей степени десяти. Количество цифр определяется заранее
+ * сравнениями со степенями десяти, поэтому выравнивание не требует промежуточного буфера.
+ *
+ * @param[in] value Значение, умноженное на 10^frac_digits.
+ * @param[in] frac_digits Количество цифр после точки, от 0 до 9.
+ * @param[in] width Минимальная ширина поля, 0 — без выравнивания.
+ * @param[in] pad Символ заполнения: ' ' или '0'.
+ * @param[in] emit Функция, получающая символы по одному слева направо.
+ * @param[in] context Указатель, передаваемый в emit без изменений.
+ * @return Количество выведенных символов.
+ */
+uint8_t fixed_emit(int32_t value, uint8_t frac_digits, uint8_t width, char pad, str_emit_t emit, void *context)
+{
+    uint32_t magnitude = fixed_magnitude(value);
+    uint8_t digits = fixed_digits(magnitude, frac_digits);
+    uint8_t length = digits + (frac_digits != 0) + (value < 0);
+    uint8_t count = 0;
+    char digit;
 
-    /* Проверка на отрицательное число */
-    if (num < 0)
+    /* Пробелы перед знаком, нули после него */
+    if (pad != '0')
     {
-        is_negative = 1;
-        num = -num;
+        for (; length + count < width; count++)
+        {
+            emit(context, pad);
+        }
     }
-
-    /* Преобразование числа в строку (обратный порядок) */
-    while (num > 0 && i < (int8_t)(sizeof(temp) - 1))
+    if (value < 0)
     {
-        temp[i++] = (char)((num % 10) + '0');
-        num /= 10;
+        emit(context, '-');
     }
-
-    /* Добавление знака минуса для отрицательных чисел */
-    if (is_negative)
+    for (; length + count < width; count++)
     {
-        temp[i++] = '-';
+        emit(context, '0');
     }
 
-    /* Разворот строки и копирование в выходной буфер */
-    for (j = 0; j < i; j++)
+    while (digits--)
     {
-        str[j] = temp[i - j - 1];
+        digit = '0';
+        while (magnitude >= str_pow10[digits])
+        {
+            magnitude -= str_pow10[digits];
+            digit++;
+        }
+
+        if (digits + 1 == frac_digits)
+        {
+            emit(context, '.');
+        }
+        emit(context, digit);
     }
-    str[j] = '\0'; /* Завершающий нулевой символ */
-}
\ No newline at end of file
+
+    return length + count;
+}
+
+/* Запись символа в строку: context указывает на текущую позицию */
+static void str_emit(void *context, char c)
+{
+    char **cursor = (char **)context;
+
+    *(*cursor)++ = c;
+}
+
+/**
+ * @brief Преобразует число с фиксированной точкой в строку.
+ *
+ * Частный случай @ref fixed_emit с выводом в буфер.
+ *
+ * @param[in] value Значение, умноженное на 10^frac_digits.
+ * @param[in] frac_digits Количество цифр после точки, от 0 до 9.
+ * @param[in] width Минимальная ширина поля, 0 — без выравнивания.
+ * @param[in] pad Символ заполнения: ' ' или '0'.
+ * @param[out] str Указатель на буфер, в который будет записана строка.
+ * @return Длина строки без завершающего нулевого символа.
+ */
+uint8_t fixed_to_str(int32_t value, uint8_t frac_digits, uint8_t width, char pad, char *str)
+{
+    char *cursor = str;
+    uint8_t length = fixed_emit(value, frac_digits, width, pad, str_emit, &cursor);
+
+    *cursor = '\0';
+    return length;
+}
@@ -3,7 +3,7 @@
  * @brief Заголовочный файл для работы со строками.
  *
  * Этот файл содержит объявление функций для работы со строками,
- * включая преобразование целого числа в строку.
+ * включая преобразование целых чисел и чисел с фиксированной точкой в строку.
  */
 
 #ifndef MY_STR_H
@@ -16,6 +16,14 @@ extern "C"
 {
 #endif
 
+    /**
+     * @brief Функция вывода одного символа для @ref fixed_emit.
+     *
+     * @param[in] context Указатель, переданный в @ref fixed_emit.
+     * @param[in] c Очередной символ.
+     */
+    typedef void (*str_emit_t)(void *context, char c);
+
     /**
      * @brief Преобразует целое число в строку.
      *
@@ -27,6 +35,51 @@ extern "C"
      */
     void int_to_str(int32_t num, char *str);
 
+    /**
+     * @brief Преобразует число с фиксированной точкой в строку.
+     *
+     * Значение задается целым числом value / 10^frac_digits, например -123 при
+     * frac_digits = 2 дает "-1.23". Цифры получаются вычитанием степеней десяти,
+     * без 32-битного деления: не более 9 вычитаний на цифру.
+     *
+     * Если строка короче width, она выравнивается вправо символом pad. При pad = '0'
+     * знак ставится перед нулями ("-01.23"). Длинная строка не обрезается.
+     * Буфер должен вмещать max(width, 12) + 1 байт.
+     *
+     * @param[in] value Значение, умноженное на 10^frac_digits.
+     * @param[in] frac_digits Количество цифр после точки, от 0 до 9.
+     * @param[in] width Минимальная ширина поля, 0 — без выравнивания.
+     * @param[in] pad Символ заполнения: ' ' или '0'.
+     * @param[out] str Указатель на буфер, в который будет записана строка.
+     * @return Длина строки без завершающего нулевого символа.
+     */
+    uint8_t fixed_to_str(int32_t value, uint8_t frac_digits, uint8_t width, char pad, char *str);
+
+    /**
+     * @brief Выводит число с фиксированной точкой посимвольно, без промежуточного буфера.
+     *
+     * Формат тот же, что у @ref fixed_to_str. Символы передаются в emit по одному слева
+     * направо, что позволяет рисовать глифы прямо в поток данных дисплея или в кэш ячеек.
+     *
+     * @param[in] value Значение, умноженное на 10^frac_digits.
+     * @param[in] frac_digits Количество цифр после точки, от 0 до 9.
+     * @param[in] width Минимальная ширина поля, 0 — без выравнивания.
+     * @param[in] pad Символ заполнения: ' ' или '0'.
+     * @param[in] emit Функция, получающая символы.
+     * @param[in] context Указатель, передаваемый в emit без изменений.
+     * @return Количество выведенных символов.
+     */
+    uint8_t fixed_emit(int32_t value, uint8_t frac_digits, uint8_t width, char pad, str_emit_t emit, void *context);
+
+    /**
+     * @brief Длина записи числа с фиксированной точкой без выравнивания.
+     *
+     * @param[in] value Значение, умноженное на 10^frac_digits.
+     * @param[in] frac_digits Количество цифр после точки, от 0 до 9.
+     * @return Количество символов, которое выведет @ref fixed_emit при width = 0.
+     */
+    uint8_t fixed_length(int32_t value, uint8_t frac_digits);
+
 #ifdef __cplusplus
 }
 #endif
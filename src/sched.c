@@ -0,0 +1,119 @@
+/**
+ * @file sched.c
+ * @brief Реализация кооперативного планировщика задач
+ */
+
+#include "sched.h"
+#include "tim4.h"
+
+static sched_task_t *sched_tasks;   /* Таблица задач, переданная в sched_start */
+static uint8_t sched_count;
+static uint8_t sched_slow;          /* Медленный режим */
+static uint32_t sched_busy_us;      /* Время выполнения задач в текущем окне */
+static uint32_t sched_window_ms;    /* Начало текущего окна */
+static uint16_t sched_load_permille; /* Загрузка за последнее окно */
+
+/* Запуск задачи и учет времени ее выполнения */
+static void sched_dispatch(sched_task_t *task, uint32_t now)
+{
+    uint32_t start;
+    uint16_t elapsed;
+    uint16_t period;
+
+    start = TIM4_GetMicros();
+    task->run();
+    elapsed = (uint16_t)TIM4_ElapsedMicros(start);
+
+    sched_busy_us += elapsed;
+    task->last_us = elapsed;
+    if (elapsed > task->max_us)
+    {
+        task->max_us = elapsed;
+    }
+    if (elapsed > task->budget_us)
+    {
+        task->overruns++;
+    }
+
+    /* Следующий запуск по сетке периода; если сетка уже пройдена, срок пропущен и сетка сдвигается */
+    period = (sched_slow && task->slow_period_ms) ? task->slow_period_ms : task->period_ms;
+    task->next_ms += period;
+    if (TIM4_REACHED(now, task->next_ms))
+    {
+        task->missed++;
+        task->next_ms = now + period;
+    }
+}
+
+/* Сон до следующего тика */
+static uint32_t sched_idle(uint32_t tick)
+{
+    /* Проверка выполняется при запрещенных прерываниях, а wfi разрешает их сам:
+     * тик между проверкой и wfi разбудит сразу, а не через миллисекунду */
+    _asm("sim");
+    while (TIM4_GetMillis() == tick)
+    {
+        _asm("wfi");
+        _asm("sim");
+    }
+    _asm("rim");
+
+    return TIM4_GetMillis();
+}
+
+void sched_start(sched_task_t *tasks, uint8_t count)
+{
+    uint32_t tick = TIM4_GetMillis();
+    uint8_t i;
+
+    sched_tasks = tasks;
+    sched_count = count;
+    for (i = 0; i < count; i++)
+    {
+        tasks[i].next_ms = tick + tasks[i].phase_ms;
+    }
+    sched_window_ms = tick;
+
+    while (1)
+    {
+        for (i = 0; i < count; i++)
+        {
+            if (TIM4_REACHED(tick, tasks[i].next_ms))
+            {
+                sched_dispatch(&tasks[i], tick);
+            }
+        }
+
+        /* Загрузка: мкс работы за 1024 мс, деленные на 1024, дают промилле */
+        if (TIM4_ELAPSED(sched_window_ms, tick) >= SCHED_LOAD_WINDOW_MS)
+        {
+            sched_load_permille = (uint16_t)(sched_busy_us >> 10);
+            sched_busy_us = 0;
+            sched_window_ms = tick;
+        }
+
+        tick = sched_idle(tick);
+    }
+}
+
+void sched_set_slow(uint8_t slow)
+{
+    uint32_t now;
+    uint8_t i;
+
+    /* При выходе из медленного режима задачи не должны ждать до конца медленного периода */
+    if (sched_slow && !slow)
+    {
+        now = TIM4_GetMillis();
+        for (i = 0; i < sched_count; i++)
+        {
+            sched_tasks[i].next_ms = now + sched_tasks[i].phase_ms;
+        }
+    }
+    sched_slow = slow;
+}
+
+uint16_t sched_load(void)
+{
+    return sched_load_permille;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file sched.h
+ * @brief Кооперативный планировщик задач на тике TIM4
+ *
+ * Задачи описываются статической таблицей: функция, период, сдвиг первого запуска и бюджет
+ * времени выполнения. На каждом тике TIM4 (1 мс) планировщик по порядку таблицы запускает
+ * задачи, срок которых наступил, а остаток миллисекунды проводит в wfi. Задачи не вытесняют
+ * друг друга, поэтому каждая должна завершаться за время, много меньшее своего периода.
+ *
+ * Для каждой задачи измеряется время выполнения, считаются превышения бюджета и пропущенные
+ * сроки. Общая загрузка процессора вычисляется по окнам @ref SCHED_LOAD_WINDOW_MS.
+ */
+
+#ifndef SCHED_H
+#define SCHED_H
+
+#include <stdint.h>
+
+/** @brief Окно измерения загрузки, мс: 1024 позволяет получить промилле сдвигом */
+#define SCHED_LOAD_WINDOW_MS 1024
+
+/**
+ * @struct sched_task_t
+ * @brief Задача планировщика
+ *
+ * Поля до budget_us задаются в таблице, остальные заполняет планировщик.
+ */
+typedef struct
+{
+    void (*run)(void);       /**< Функция задачи */
+    uint16_t period_ms;      /**< Период запуска */
+    uint16_t slow_period_ms; /**< Период в медленном режиме (@ref sched_set_slow), 0 — как period_ms */
+    uint8_t phase_ms;        /**< Сдвиг первого запуска относительно @ref sched_start */
+    uint16_t budget_us;      /**< Бюджет времени выполнения */
+    uint32_t next_ms;        /**< Время следующего запуска */
+    uint16_t last_us;        /**< Последнее измеренное время выполнения */
+    uint16_t max_us;         /**< Наибольшее измеренное время выполнения */
+    uint16_t overruns;       /**< Количество превышений бюджета */
+    uint16_t missed;         /**< Количество пропущенных сроков (запуск позже следующего периода) */
+} sched_task_t;
+
+/**
+ * @brief Запуск планировщика
+ *
+ * Назначает первые запуски задач со сдвигами phase_ms от текущего момента и выполняет
+ * задачи до бесконечности. Задачи одного тика выполняются в порядке таблицы, поэтому
+ * сдвиги задают порядок стадий обработки внутри кадра.
+ *
+ * @param tasks Таблица задач
+ * @param count Количество задач
+ */
+void sched_start(sched_task_t *tasks, uint8_t count);
+
+/**
+ * @brief Переключение медленного режима
+ *
+ * В медленном режиме задачи запускаются с периодом slow_period_ms (например, пока датчик
+ * в покое). Новый период применяется со следующего запуска каждой задачи. При выходе из
+ * медленного режима сроки всех задач назначаются заново: текущее время плюс phase_ms.
+ * Вызывается из задачи, которая сама не замедляется (slow_period_ms = 0).
+ *
+ * @param slow 1 — медленный режим, 0 — обычный
+ */
+void sched_set_slow(uint8_t slow);
+
+/**
+ * @brief Загрузка процессора за последнее завершенное окно
+ *
+ * @return Доля времени выполнения задач в промилле (0..1000); остальное время — сон в wfi
+ */
+uint16_t sched_load(void);
+
+#endif /* SCHED_H */
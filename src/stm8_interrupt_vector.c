@@ -11,6 +11,8 @@ struct interrupt_vector
 
 @far @interrupt void NonHandledInterrupt(void) { /* ... */ }
 
+@far @interrupt void ADXL345_IRQHandler(void);
+@far @interrupt void I2C_IRQHandler(void);
 @far @interrupt void TIM4_UPD_OVF_IRQHandler(void);
 
 extern void _stext();
@@ -24,7 +26,7 @@ struct interrupt_vector const _vectab[] = {
 	{0x82, NonHandledInterrupt},		 /* irq3  */
 	{0x82, NonHandledInterrupt},		 /* irq4  */
 	{0x82, NonHandledInterrupt},		 /* irq5  */
-	{0x82, NonHandledInterrupt},		 /* irq6  */
+	{0x82, ADXL345_IRQHandler},			 /* irq6  - EXTI PORTD (ADXL345 INT1) */
 	{0x82, NonHandledInterrupt},		 /* irq7  */
 	{0x82, NonHandledInterrupt},		 /* irq8  */
 	{0x82, NonHandledInterrupt},		 /* irq9  */
@@ -37,7 +39,7 @@ struct interrupt_vector const _vectab[] = {
 	{0x82, NonHandledInterrupt},		 /* irq16 */
 	{0x82, NonHandledInterrupt},		 /* irq17 */
 	{0x82, NonHandledInterrupt},		 /* irq18 */
-	{0x82, NonHandledInterrupt},		 /* irq19 */
+	{0x82, I2C_IRQHandler},				 /* irq19 - I2C */
 	{0x82, NonHandledInterrupt},		 /* irq20 */
 	{0x82, NonHandledInterrupt},		 /* irq21 */
 	{0x82, NonHandledInterrupt},		 /* irq22 */
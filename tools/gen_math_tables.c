@@ -0,0 +1,145 @@
+/**
+ * @file gen_math_tables.c
+ * @brief Генератор таблиц atan/sqrt/rsqrt для my_math (запускается на ПК)
+ *
+ * Формирует src/my_math_tables.h: таблицы для всех поддерживаемых размеров 2^n + 1, n от
+ * MATH_TABLE_LOG2_MIN до MATH_TABLE_LOG2_MAX. Нужный размер выбирается при сборке макросом
+ * MATH_TABLE_LOG2. Для каждого размера генератор повторяет целочисленную интерполяцию
+ * my_math.c и записывает в комментарий наибольшую погрешность.
+ *
+ * Сборка и запуск из корня репозитория:
+ *
+ *     gcc -O2 -o gen_math_tables tools/gen_math_tables.c -lm
+ *     ./gen_math_tables > src/my_math_tables.h
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define MATH_TABLE_LOG2_MIN 4
+#define MATH_TABLE_LOG2_MAX 7
+
+#define ATAN_SCALE 4.0       /* atan: сотые доли градуса << 2 */
+#define SQRT_SCALE 65536.0   /* sqrt(u), u = [1/4, 1]: Q16 */
+#define RSQRT_SCALE 32768.0  /* 1/sqrt(u), u = [1/4, 1]: Q15 */
+#define TEST_STEPS 100000
+
+static const double pi = 3.14159265358979323846;
+
+static uint16_t quantize(double value)
+{
+    value = floor(value + 0.5);
+    return (value > 65535.0) ? 65535 : (uint16_t)value;
+}
+
+static void fill_tables(unsigned log2, uint16_t *atan_t, uint16_t *sqrt_t, uint16_t *rsqrt_t)
+{
+    unsigned size = 1U << log2;
+    unsigned i;
+
+    for (i = 0; i <= size; i++)
+    {
+        double t = (double)i / size;
+        double u = 0.25 + 0.75 * t;
+
+        atan_t[i] = quantize(atan(t) * 18000.0 / pi * ATAN_SCALE);
+        sqrt_t[i] = quantize(sqrt(u) * SQRT_SCALE);
+        rsqrt_t[i] = quantize(RSQRT_SCALE / sqrt(u));
+    }
+}
+
+/* Та же интерполяция, что в my_math.c: position в Q15 на [0, 1] */
+static uint16_t interpolate(const uint16_t *table, unsigned log2, uint16_t position)
+{
+    unsigned shift = 15 - log2;
+    unsigned index = position >> shift;
+    uint32_t frac = position & ((1U << shift) - 1);
+    int32_t delta;
+
+    if (index >= (1U << log2))
+    {
+        return table[1U << log2];
+    }
+    delta = (int32_t)table[index + 1] - table[index];
+    return (uint16_t)(table[index] + ((delta * (int32_t)frac + (1L << (shift - 1))) >> shift));
+}
+
+static void print_table(const char *name, const uint16_t *table, unsigned log2)
+{
+    unsigned i;
+
+    printf("static const uint16_t %s[MATH_TABLE_SIZE] = {", name);
+    for (i = 0; i <= (1U << log2); i++)
+    {
+        printf("%s%5u,", (i % 8) ? " " : "\n    ", table[i]);
+    }
+    printf("\n};\n");
+}
+
+static void emit(unsigned log2)
+{
+    uint16_t atan_t[(1U << MATH_TABLE_LOG2_MAX) + 1];
+    uint16_t sqrt_t[(1U << MATH_TABLE_LOG2_MAX) + 1];
+    uint16_t rsqrt_t[(1U << MATH_TABLE_LOG2_MAX) + 1];
+    double atan_err = 0, sqrt_err = 0, rsqrt_err = 0;
+    unsigned step;
+
+    fill_tables(log2, atan_t, sqrt_t, rsqrt_t);
+
+    for (step = 0; step <= TEST_STEPS; step++)
+    {
+        uint16_t position = (uint16_t)((32768UL * step) / TEST_STEPS);
+        double t = position / 32768.0;
+        double u = 0.25 + 0.75 * t;
+        double e;
+
+        e = fabs(interpolate(atan_t, log2, position) / ATAN_SCALE - atan(t) * 18000.0 / pi);
+        atan_err = (e > atan_err) ? e : atan_err;
+        e = fabs(interpolate(sqrt_t, log2, position) / SQRT_SCALE - sqrt(u)) / sqrt(u);
+        sqrt_err = (e > sqrt_err) ? e : sqrt_err;
+        e = fabs(interpolate(rsqrt_t, log2, position) / RSQRT_SCALE - 1.0 / sqrt(u)) * sqrt(u);
+        rsqrt_err = (e > rsqrt_err) ? e : rsqrt_err;
+    }
+
+    printf("\n#%s MATH_TABLE_LOG2 == %u\n\n", (log2 == MATH_TABLE_LOG2_MIN) ? "if" : "elif", log2);
+    printf("/*\n * %u точек, %u байт FLASH на все таблицы. Наибольшая погрешность интерполяции:\n",
+           (1U << log2) + 1, 3 * 2 * ((1U << log2) + 1));
+    printf(" * atan %.4f градуса, sqrt %.1e, rsqrt %.1e (относительная)\n */\n", atan_err / 100.0, sqrt_err,
+           rsqrt_err);
+    printf("#define MATH_TABLE_ATAN_ERROR_CDEG %u\n\n", (unsigned)ceil(atan_err));
+    print_table("math_atan_table", atan_t, log2);
+    print_table("math_sqrt_table", sqrt_t, log2);
+    print_table("math_rsqrt_table", rsqrt_t, log2);
+}
+
+int main(void)
+{
+    unsigned log2;
+
+    printf("/**\n");
+    printf(" * @file my_math_tables.h\n");
+    printf(" * @brief Таблицы atan/sqrt/rsqrt для интерполяции, хранимые во FLASH\n");
+    printf(" *\n");
+    printf(" * Файл сформирован tools/gen_math_tables.c, не редактировать вручную.\n");
+    printf(" *\n");
+    printf(" * Каждая таблица содержит MATH_TABLE_SIZE = 2^MATH_TABLE_LOG2 + 1 равноотстоящих точек:\n");
+    printf(" * - math_atan_table:  atan(t), t = [0, 1], сотые доли градуса << 2;\n");
+    printf(" * - math_sqrt_table:  sqrt(u), u = [1/4, 1], Q16 (насыщение до 65535);\n");
+    printf(" * - math_rsqrt_table: 1/sqrt(u), u = [1/4, 1], Q15 (насыщение до 65535).\n");
+    printf(" */\n\n");
+    printf("#ifndef MY_MATH_TABLES_H\n#define MY_MATH_TABLES_H\n\n#include <stdint.h>\n\n");
+    printf("/** @brief log2 числа интервалов таблиц, от %d до %d */\n", MATH_TABLE_LOG2_MIN, MATH_TABLE_LOG2_MAX);
+    printf("#ifndef MATH_TABLE_LOG2\n#define MATH_TABLE_LOG2 5\n#endif\n\n");
+    printf("/** @brief Число точек таблицы */\n#define MATH_TABLE_SIZE ((1 << MATH_TABLE_LOG2) + 1)\n");
+
+    for (log2 = MATH_TABLE_LOG2_MIN; log2 <= MATH_TABLE_LOG2_MAX; log2++)
+    {
+        emit(log2);
+    }
+
+    printf("\n#else\n#error \"MATH_TABLE_LOG2 must be in range %d..%d\"\n#endif\n\n", MATH_TABLE_LOG2_MIN,
+           MATH_TABLE_LOG2_MAX);
+    printf("#endif // MY_MATH_TABLES_H\n");
+    return 0;
+}
@@ -0,0 +1,323 @@
+/**
+ * @file math_bench.c
+ * @brief Стенд точности и быстродействия my_math/my_cordic (запускается на ПК)
+ *
+ * Каждое ядро из таблицы kernels прогоняется по сетке входных значений и сравнивается с libm.
+ * Выводятся наибольшая и среднеквадратичная погрешность, вход с наибольшей погрешностью и
+ * время одного вызова в наносекундах. Новое ядро добавляется строкой в таблицу kernels
+ * с функцией-оберткой нужного вида, после чего сравнивается с остальными на тех же входах.
+ *
+ * Время на ПК не равно времени на STM8, но соотношение между ядрами (деления, плавающая
+ * точка, число итераций) сохраняется.
+ *
+ * Сборка и запуск из корня репозитория:
+ *
+ *     gcc -O2 -Isrc -o math_bench tools/math_bench.c src/my_math.c src/my_cordic.c -lm
+ *     ./math_bench [шаг сетки] [предел отсчетов]
+ *
+ * По умолчанию углы проверяются на сетке x, y, z = -4096..4096 с шагом 64: это диапазон
+ * выхода дециматора (±4g в режиме Full Resolution, 2 дробных бита). Шаг 1 перебирает все точки.
+ * Целочисленные atan2 дополнительно проверяются на всем диапазоне int32 (модули от 2^16 до 2^31).
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "my_cordic.h"
+#include "my_math.h"
+
+#define RAD_TO_DEG (180.0 / 3.14159265358979323846)
+
+#define DEFAULT_STEP 64
+#define DEFAULT_LIMIT 4096
+#define SCALAR_POINTS 1000000L
+
+/** @brief Вид ядра: определяет сигнатуру обертки и эталон libm */
+typedef enum
+{
+    KERNEL_ROLL,       /**< Крен по (x, y, z), градусы */
+    KERNEL_PITCH,      /**< Тангаж по (x, y, z), градусы */
+    KERNEL_ATAN2,      /**< atan2(y, x) по отсчетам, градусы */
+    KERNEL_ATAN2_WIDE, /**< atan2(y, x) на всем диапазоне int32 (без CORDIC: вход до 65535), градусы */
+    KERNEL_ATAN,       /**< atan(z), z = [-4, 4], градусы */
+    KERNEL_SQRT        /**< sqrt(x), x = [0, 2^31) */
+} kernel_kind_t;
+
+/** @brief Ядро: обертка приводит результат к double в единицах эталона */
+typedef struct
+{
+    const char *name;
+    kernel_kind_t kind;
+    double (*xyz)(int16_t x, int16_t y, int16_t z);
+    double (*scalar)(double a, double b);
+} kernel_t;
+
+/** @brief Статистика одного прогона */
+typedef struct
+{
+    double max_error;
+    double sum_squares;
+    double worst[3];
+    long count;
+    double ns_per_call;
+} result_t;
+
+/* Обертки ядер */
+
+static double roll_float(int16_t x, int16_t y, int16_t z) { return calculate_roll(x, y, z); }
+static double pitch_float(int16_t x, int16_t y, int16_t z) { return calculate_pitch(x, y, z); }
+static double roll_fixed(int16_t x, int16_t y, int16_t z) { return calculate_roll_cdeg(x, y, z) / 100.0; }
+static double pitch_fixed(int16_t x, int16_t y, int16_t z) { return calculate_pitch_cdeg(x, y, z) / 100.0; }
+
+static double roll_cordic(int16_t x, int16_t y, int16_t z)
+{
+    uint32_t xz;
+
+    cordic_polar(z, x, &xz);
+    return cordic_atan2(y, (int32_t)xz) / 100.0;
+}
+
+static double pitch_cordic(int16_t x, int16_t y, int16_t z)
+{
+    uint32_t yz;
+
+    cordic_polar(z, y, &yz);
+    return cordic_atan2(-(int32_t)x, (int32_t)yz) / 100.0;
+}
+
+static double roll_lut(int16_t x, int16_t y, int16_t z)
+{
+    return my_atan2_lut_cdeg(y, my_sqrt_lut((uint32_t)((int32_t)x * x) + (uint32_t)((int32_t)z * z))) / 100.0;
+}
+
+static double atan2_float(double y, double x) { return my_atan2((float)y, (float)x) * RAD_TO_DEG; }
+static double atan2_fixed(double y, double x) { return my_atan2_cdeg((int32_t)y, (int32_t)x) / 100.0; }
+static double atan2_lut(double y, double x) { return my_atan2_lut_cdeg((int32_t)y, (int32_t)x) / 100.0; }
+static double atan2_cordic(double y, double x) { return cordic_atan2((int32_t)y, (int32_t)x) / 100.0; }
+
+static double atan_float(double z, double unused)
+{
+    (void)unused;
+    return my_atan((float)z) * RAD_TO_DEG;
+}
+
+static double sqrt_float(double x, double unused)
+{
+    (void)unused;
+    return my_sqrt((float)x);
+}
+
+static double sqrt_isqrt(double x, double unused)
+{
+    (void)unused;
+    return my_isqrt((uint32_t)x);
+}
+
+static double sqrt_lut(double x, double unused)
+{
+    (void)unused;
+    return my_sqrt_lut((uint32_t)x);
+}
+
+/* Реестр ядер: одинаковые kind сравниваются на одних и тех же входах */
+static const kernel_t kernels[] = {
+    {"calculate_roll (float)", KERNEL_ROLL, roll_float, 0},
+    {"calculate_roll_cdeg", KERNEL_ROLL, roll_fixed, 0},
+    {"cordic roll", KERNEL_ROLL, roll_cordic, 0},
+    {"lut roll", KERNEL_ROLL, roll_lut, 0},
+    {"calculate_pitch (float)", KERNEL_PITCH, pitch_float, 0},
+    {"calculate_pitch_cdeg", KERNEL_PITCH, pitch_fixed, 0},
+    {"cordic pitch", KERNEL_PITCH, pitch_cordic, 0},
+    {"my_atan2 (float)", KERNEL_ATAN2, 0, atan2_float},
+    {"my_atan2_cdeg", KERNEL_ATAN2, 0, atan2_fixed},
+    {"my_atan2_lut_cdeg", KERNEL_ATAN2, 0, atan2_lut},
+    {"cordic_atan2", KERNEL_ATAN2, 0, atan2_cordic},
+    {"my_atan2 (float)", KERNEL_ATAN2_WIDE, 0, atan2_float},
+    {"my_atan2_cdeg", KERNEL_ATAN2_WIDE, 0, atan2_fixed},
+    {"my_atan2_lut_cdeg", KERNEL_ATAN2_WIDE, 0, atan2_lut},
+    {"my_atan (float)", KERNEL_ATAN, 0, atan_float},
+    {"my_sqrt (float)", KERNEL_SQRT, 0, sqrt_float},
+    {"my_isqrt", KERNEL_SQRT, 0, sqrt_isqrt},
+    {"my_sqrt_lut", KERNEL_SQRT, 0, sqrt_lut},
+};
+
+#define KERNEL_COUNT (sizeof(kernels) / sizeof(kernels[0]))
+
+static const char *kind_names[] = {"roll, deg", "pitch, deg", "atan2, deg", "atan2 i32", "atan, deg", "sqrt, abs"};
+
+static volatile double sink; /* Не дает компилятору выбросить вызовы при замере времени */
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Эталон libm */
+static double reference_xyz(kernel_kind_t kind, int16_t x, int16_t y, int16_t z)
+{
+    if (kind == KERNEL_ROLL)
+    {
+        return atan2(y, hypot(x, z)) * RAD_TO_DEG;
+    }
+    return atan2(-x, hypot(y, z)) * RAD_TO_DEG;
+}
+
+static double reference_scalar(kernel_kind_t kind, double a, double b)
+{
+    switch (kind)
+    {
+    case KERNEL_ATAN2:
+    case KERNEL_ATAN2_WIDE:
+        return atan2(a, b) * RAD_TO_DEG;
+    case KERNEL_ATAN:
+        return atan(a) * RAD_TO_DEG;
+    default:
+        return sqrt(a);
+    }
+}
+
+/* Точка i из SCALAR_POINTS для скалярных ядер; LCG дает одинаковую последовательность для всех ядер */
+static void scalar_point(kernel_kind_t kind, long i, int limit, double *a, double *b)
+{
+    static uint32_t state;
+    uint32_t r1, r2;
+
+    if (i == 0)
+    {
+        state = 12345;
+    }
+    state = state * 1664525UL + 1013904223UL;
+    r1 = state >> 8;
+    state = state * 1664525UL + 1013904223UL;
+    r2 = state >> 8;
+
+    switch (kind)
+    {
+    case KERNEL_ATAN2:
+        *a = (double)((int32_t)(r1 % (2U * limit + 1)) - limit);
+        *b = (double)((int32_t)(r2 % (2U * limit + 1)) - limit);
+        break;
+    case KERNEL_ATAN2_WIDE:
+        /* Слово int32 со сдвигом на 0..15 разрядов: модули от 2^16 до 2^31 представлены равномерно по порядкам */
+        *a = (double)((int32_t)(r1 << 8 | (r2 & 0xFF)) >> (r2 >> 8 & 0x0F));
+        state = state * 1664525UL + 1013904223UL;
+        r1 = state >> 8;
+        state = state * 1664525UL + 1013904223UL;
+        r2 = state >> 8;
+        *b = (double)((int32_t)(r1 << 8 | (r2 & 0xFF)) >> (r2 >> 8 & 0x0F));
+        break;
+    case KERNEL_ATAN:
+        *a = -4.0 + 8.0 * i / (SCALAR_POINTS - 1);
+        *b = 0;
+        break;
+    default:
+        *a = (double)(((uint32_t)r1 << 8 | (r2 & 0xFF)) & 0x7FFFFFFFUL);
+        *b = 0;
+        break;
+    }
+}
+
+static void account(result_t *result, double error, double a, double b, double c)
+{
+    error = fabs(error);
+    if (error > 180.0 && error < 360.0)
+    {
+        error = 360.0 - error; // -180 и 180 — один и тот же угол
+    }
+    result->sum_squares += error * error;
+    result->count++;
+    if (error > result->max_error)
+    {
+        result->max_error = error;
+        result->worst[0] = a;
+        result->worst[1] = b;
+        result->worst[2] = c;
+    }
+}
+
+static void run_xyz(const kernel_t *kernel, int step, int limit, result_t *result)
+{
+    double start, sum = 0;
+    int x, y, z;
+
+    for (x = -limit; x <= limit; x += step)
+        for (y = -limit; y <= limit; y += step)
+            for (z = -limit; z <= limit; z += step)
+            {
+                account(result, kernel->xyz(x, y, z) - reference_xyz(kernel->kind, x, y, z), x, y, z);
+            }
+
+    start = now_ns();
+    for (x = -limit; x <= limit; x += step)
+        for (y = -limit; y <= limit; y += step)
+            for (z = -limit; z <= limit; z += step)
+            {
+                sum += kernel->xyz(x, y, z);
+            }
+    result->ns_per_call = (now_ns() - start) / result->count;
+    sink = sum;
+}
+
+static void run_scalar(const kernel_t *kernel, int limit, result_t *result)
+{
+    double start, sum = 0, a, b;
+    long i;
+
+    for (i = 0; i < SCALAR_POINTS; i++)
+    {
+        scalar_point(kernel->kind, i, limit, &a, &b);
+        account(result, kernel->scalar(a, b) - reference_scalar(kernel->kind, a, b), a, b, 0);
+    }
+
+    start = now_ns();
+    for (i = 0; i < SCALAR_POINTS; i++)
+    {
+        scalar_point(kernel->kind, i, limit, &a, &b);
+        sum += kernel->scalar(a, b);
+    }
+    result->ns_per_call = (now_ns() - start) / SCALAR_POINTS;
+    sink = sum;
+}
+
+int main(int argc, char **argv)
+{
+    int step = (argc > 1) ? atoi(argv[1]) : DEFAULT_STEP;
+    int limit = (argc > 2) ? atoi(argv[2]) : DEFAULT_LIMIT;
+    unsigned i;
+
+    if (step < 1 || limit < 1 || limit > 32767)
+    {
+        fprintf(stderr, "usage: %s [step >= 1] [limit 1..32767]\n", argv[0]);
+        return 1;
+    }
+
+    printf("grid: x, y, z = %d..%d step %d; scalar kernels: %ld points\n\n", -limit, limit, step, SCALAR_POINTS);
+    printf("%-26s %-11s %12s %12s %9s  %s\n", "kernel", "kind", "max error", "rms error", "ns/call", "worst input");
+
+    for (i = 0; i < KERNEL_COUNT; i++)
+    {
+        const kernel_t *kernel = &kernels[i];
+        result_t result = {0};
+
+        if (kernel->xyz)
+        {
+            run_xyz(kernel, step, limit, &result);
+        }
+        else
+        {
+            run_scalar(kernel, limit, &result);
+        }
+
+        printf("%-26s %-11s %12.5f %12.5f %9.1f  (%g, %g, %g)\n", kernel->name, kind_names[kernel->kind],
+               result.max_error, sqrt(result.sum_squares / result.count), result.ns_per_call, result.worst[0],
+               result.worst[1], result.worst[2]);
+    }
+
+    return 0;
+}
@@ -0,0 +1,222 @@
+/**
+ * @file ssd1306_bench.c
+ * @brief Стенд нагрузки на шину I2C при полном обновлении экрана SSD1306 (запускается на ПК)
+ *
+ * Драйвер ssd1306.c собирается вместе с заглушкой I2C, которая считает транзакции и байты
+ * на шине (адрес, контрольный байт, данные). Прежний способ передачи — одна транзакция на каждый
+ * байт данных и на каждую команду — воспроизведен здесь теми же примитивами I2C для сравнения.
+ *
+ * Время оценивается по числу битов на шине: 9 тактов SCL на байт (8 бит + ACK) и 2 такта
+ * на пару START/STOP, без учета растяжения такта ведомым и задержек программы.
+ *
+ * Сборка и запуск из корня репозитория:
+ *
+ *     gcc -O2 -Isrc -Isrc/drivers/ssd1306 -Isrc/drivers/i2c -Isrc/drivers/clk \
+ *         -o ssd1306_bench tools/ssd1306_bench.c src/drivers/ssd1306/ssd1306.c src/my_str.c
+ *     ./ssd1306_bench
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "i2c.h"
+#include "ssd1306.h"
+#include "ssd1306_text.h"
+
+/** @brief Счетчики шины */
+typedef struct
+{
+    unsigned long transactions;
+    unsigned long bytes;
+} bus_stats_t;
+
+static bus_stats_t bus;
+
+/* Заглушка I2C: каждое обращение к шине только учитывается */
+
+I2C_Status_t I2C_Start(void)
+{
+    bus.transactions++;
+    return I2C_OK;
+}
+
+I2C_Status_t I2C_Stop(void)
+{
+    return I2C_OK;
+}
+
+I2C_Status_t I2C_WriteAddress(uint8_t address)
+{
+    (void)address;
+    bus.bytes++;
+    return I2C_OK;
+}
+
+I2C_Status_t I2C_WriteData(uint8_t data)
+{
+    (void)data;
+    bus.bytes++;
+    return I2C_OK;
+}
+
+void I2C_Submit(I2C_Transaction_t *transaction)
+{
+    bus.transactions++;
+    bus.bytes += 1 + transaction->header_len + transaction->tx_len + transaction->rx_len;
+    transaction->status = I2C_OK;
+    if (transaction->callback)
+    {
+        transaction->callback(transaction);
+    }
+}
+
+/* Прежний способ передачи (до потокового интерфейса): транзакция на каждый байт */
+
+static void legacy_command(uint8_t command)
+{
+    I2C_Start();
+    I2C_WriteAddress(SSD1306_I2C_ADDRESS);
+    I2C_WriteData(SSD1306_COMMAND);
+    I2C_WriteData(command);
+    I2C_Stop();
+}
+
+static void legacy_data(uint8_t data)
+{
+    I2C_Start();
+    I2C_WriteAddress(SSD1306_I2C_ADDRESS);
+    I2C_WriteData(SSD1306_DATA);
+    I2C_WriteData(data);
+    I2C_Stop();
+}
+
+static void legacy_cursor(uint8_t column, uint8_t page)
+{
+    legacy_command(0xB0 | (page & 0x07));
+    legacy_command(0x00 | (column & 0x0F));
+    legacy_command(0x10 | ((column >> 4) & 0x0F));
+}
+
+static void legacy_clear(void)
+{
+    uint8_t page, column;
+
+    for (page = 0; page < SSD1306_PAGES; page++)
+    {
+        legacy_cursor(0, page);
+        for (column = 0; column < SSD1306_WIDTH; column++)
+        {
+            legacy_data(0x00);
+        }
+    }
+}
+
+static void legacy_bitmap(const uint8_t *bitmap)
+{
+    uint8_t page, column;
+
+    for (page = 0; page < SSD1306_PAGES; page++)
+    {
+        legacy_cursor(0, page);
+        for (column = 0; column < SSD1306_WIDTH; column++)
+        {
+            legacy_data(bitmap[page * SSD1306_WIDTH + column]);
+        }
+    }
+}
+
+static void legacy_text(const char *line)
+{
+    uint8_t page, i;
+    const char *c;
+
+    for (page = 0; page < SSD1306_PAGES; page++)
+    {
+        legacy_cursor(0, page);
+        for (c = line; *c; c++)
+        {
+            /* Содержимое глифа на объем передачи не влияет: 5 столбцов и интервал */
+            for (i = 0; i < SSD1306_TEXT_CELL_WIDTH; i++)
+            {
+                legacy_data(0x00);
+            }
+        }
+    }
+}
+
+/* Текущий способ передачи */
+
+static void stream_clear(void)
+{
+    SSD1306_Clear();
+}
+
+static void stream_bitmap(const uint8_t *bitmap)
+{
+    SSD1306_DrawBitmap(0, 0, bitmap, SSD1306_WIDTH, SSD1306_PAGES * 8);
+}
+
+static void stream_text(const char *line)
+{
+    uint8_t page;
+
+    for (page = 0; page < SSD1306_PAGES; page++)
+    {
+        SSD1306_SetCursor(0, page);
+        SSD1306_WriteString(line);
+    }
+}
+
+static double bus_time_ms(const bus_stats_t *stats, double scl_hz)
+{
+    return (stats->bytes * 9.0 + stats->transactions * 2.0) / scl_hz * 1000.0;
+}
+
+static void report(const char *name, const bus_stats_t *before, const bus_stats_t *after)
+{
+    printf("%-23s %7lu %7lu  -> %5lu %6lu   %6.1f -> %5.1f   %5.1f -> %5.1f\n", name, before->transactions,
+           before->bytes, after->transactions, after->bytes, bus_time_ms(before, 100000.0),
+           bus_time_ms(after, 100000.0), bus_time_ms(before, 400000.0), bus_time_ms(after, 400000.0));
+}
+
+int main(void)
+{
+    static uint8_t bitmap[SSD1306_WIDTH * SSD1306_PAGES];
+    const char *line = "System time: 12:34:56"; /* 21 символ — полная строка */
+    bus_stats_t before, after;
+    unsigned i;
+
+    for (i = 0; i < sizeof(bitmap); i++)
+    {
+        bitmap[i] = (uint8_t)(i * 37);
+    }
+
+    printf("%-23s %15s     %12s   %15s   %14s\n", "full-screen refresh", "xfers   bytes", "xfers  bytes",
+           "ms @ 100 kHz", "ms @ 400 kHz");
+
+    bus = (bus_stats_t){0, 0};
+    legacy_clear();
+    before = bus;
+    bus = (bus_stats_t){0, 0};
+    stream_clear();
+    after = bus;
+    report("SSD1306_Clear", &before, &after);
+
+    bus = (bus_stats_t){0, 0};
+    legacy_bitmap(bitmap);
+    before = bus;
+    bus = (bus_stats_t){0, 0};
+    stream_bitmap(bitmap);
+    after = bus;
+    report("SSD1306_DrawBitmap", &before, &after);
+
+    bus = (bus_stats_t){0, 0};
+    legacy_text(line);
+    before = bus;
+    bus = (bus_stats_t){0, 0};
+    stream_text(line);
+    after = bus;
+    report("8 x SSD1306_WriteString", &before, &after);
+
+    return 0;
+}